@@ -0,0 +1,140 @@
+#include "headless.h"
+#include "synthetic.h"
+#include "cppgen.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//Measures the hot paths of imrad_core on synthetic designs of 10^2..10^max widgets.
+//usage: imrad_bench [--max N] [--frames N]
+
+template <class F>
+static double Measure(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void Report(const char* name, int widgets, double ms, const std::string& extra = "")
+{
+    std::printf("%-12s %8d %12.2f ms  %s\n", name, widgets, ms, extra.c_str());
+    std::fflush(stdout);
+}
+
+static void Run(int widgets, int frames, const fs::path& dir, UIContext& ctx)
+{
+    CppGen codeGen;
+    codeGen.SetNamesFromId("bench");
+    ctx.codeGen = &codeGen;
+
+    DesignShape shape;
+    shape.widgets = widgets;
+    std::unique_ptr<TopWindow> top;
+    double ms = Measure([&] { top = GenerateDesign(shape, ctx); });
+    Report("create", widgets, ms);
+
+    //cloning configurations and closing files go through NodeArena
+    std::unique_ptr<TopWindow> clone;
+    ms = Measure([&] { clone = top->Clone(ctx); });
+    Report("clone", widgets, ms, std::to_string(NodeArena::Current()->Used() / 1024) + " KB nodes");
+    ms = Measure([&] { clone.reset(); });
+    Report("teardown", widgets, ms);
+
+    //read and write back every property like the property grid and Clone do
+    auto nodes = top->GetAllChildren();
+    size_t nprops = 0;
+    ms = Measure([&] {
+        for (UINode* node : nodes) {
+            const auto& tab = node->GetPropTable();
+            for (const auto* entries : { &tab.props, &tab.events })
+                for (const auto& e : *entries) {
+                    property_base* prop = node->PropAt(e);
+                    prop->set_from_arg(prop->to_arg());
+                    ++nprops;
+                }
+        }
+        });
+    Report("properties", widgets, ms, std::to_string(nprops) + " props");
+
+    std::vector<UINode*> roots{ top.get() };
+    std::vector<std::string> used;
+    ctx.varUsage.Invalidate();
+    ms = Measure([&] { used = ctx.varUsage.UsedVars(roots); });
+    Report("varIndex", widgets, ms, std::to_string(used.size()) + " vars");
+    if (used.size()) {
+        ms = Measure([&] {
+            ctx.varUsage.Rename(roots, used[0], used[0] + "_renamed");
+            ctx.varUsage.Rename(roots, used[0] + "_renamed", used[0]);
+            });
+        Report("rename", widgets, ms / 2);
+    }
+
+    ctx.allRoots = roots;
+    ms = Measure([&] {
+        for (int i = 0; i < frames; ++i)
+            DrawHeadless(top.get(), ctx);
+        });
+    Report("layout", widgets, ms / frames, "per frame");
+
+    std::string fname = u8string(dir / "bench.h");
+    std::error_code err;
+    fs::remove(dir / "bench.h", err);
+    fs::remove(dir / "bench.cpp", err);
+    std::vector<CppGen::Config> configs(1);
+    configs[0].node = top.get();
+    configs[0].params = { { "style", "Dark" }, { "unit", ctx.unit } };
+    std::string error;
+    ms = Measure([&] { codeGen.ExportUpdate(fname, configs, error); });
+    //second export merges into the existing files which is what saving does
+    double ms2 = Measure([&] { codeGen.ExportUpdate(fname, configs, error); });
+    auto bytes = fs::file_size(dir / "bench.h", err) + fs::file_size(dir / "bench.cpp", err);
+    Report("export", widgets, ms, std::to_string(bytes / 1024) + " KB");
+    Report("exportMerge", widgets, ms2, std::to_string(bytes / (1024 * 1024 * ms2 / 1000)) + " MB/s");
+
+    CppGen codeGen2;
+    std::vector<CppGen::Config> imported;
+    //imported document gets its own arena like in the designer
+    NodeArena* arena = NodeArena::Create();
+    {
+        NodeArena::Scope scope(arena);
+        ms = Measure([&] { imported = codeGen2.Import(fname, error); });
+    }
+    Report("import", widgets, ms, std::to_string(arena->Reserved() / 1024) + " KB pool");
+    for (auto& cfg : imported)
+        delete cfg.node;
+    arena->Release();
+
+    ctx.allRoots.clear();
+    ctx.selected.clear();
+    top.reset();
+    ctx.codeGen = nullptr;
+}
+
+int main(int argc, const char* argv[])
+{
+    int maxWidgets = 100000;
+    int frames = 10;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!std::strcmp(argv[i], "--max"))
+            maxWidgets = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--frames"))
+            frames = std::max(1, std::atoi(argv[i + 1]));
+    }
+
+    fs::path dir = fs::temp_directory_path() / "imrad_bench";
+    std::error_code err;
+    fs::create_directories(dir, err);
+
+    UIContext ctx;
+    InitHeadless(ctx);
+    std::printf("%-12s %8s %15s\n", "operation", "widgets", "time");
+    for (int n = 100; n <= maxWidgets; n *= 10)
+        Run(n, frames, dir, ctx);
+    ShutdownHeadless();
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "utils.h"
+#include "cpp_parser.h"
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+
+//Drives cpp::token_iterator, cpp::stmt_iterator and the expression helpers
+//with arbitrary input. Built as a libFuzzer target with IMRAD_FUZZ_LIBFUZZER,
+//otherwise a small driver replays the files given on the command line
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    std::string code((const char*)data, size);
+    {
+        std::istringstream in(code);
+        for (cpp::token_iterator it(in); it != cpp::token_iterator(); ++it)
+            ;
+    }
+    {
+        std::istringstream in(code);
+        for (cpp::token_iterator it(in, true); it != cpp::token_iterator(); ++it)
+            ;
+    }
+    {
+        std::istringstream in(code);
+        for (cpp::stmt_iterator sit(cpp::token_iterator{ in }); sit != cpp::stmt_iterator(); ++sit)
+            ;
+    }
+    size_t i = 0;
+    cpp::find_id(code, i);
+    cpp::parse_str_arg(code);
+    cpp::replace_id(code, "x", "y");
+    return 0;
+}
+
+#ifndef IMRAD_LIBFUZZER
+int main(int argc, const char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::ifstream fin(u8path(argv[i]), std::ios::binary);
+        std::string data(std::istreambuf_iterator<char>(fin), {});
+        LLVMFuzzerTestOneInput((const uint8_t*)data.data(), data.size());
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,79 @@
+#include "headless.h"
+#include "node_window.h"
+#include "stx.h"
+#include "utils.h"
+#include <imgui_internal.h>
+
+#define IMRAD_H_IMPLEMENTATION
+#include "imrad.h"
+
+//must come last
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+ImTextureID UploadTexture(const unsigned char*, int, int)
+{
+    return ImTextureID_Invalid;
+}
+
+void DeleteTexture(ImTextureID)
+{
+}
+
+bool OpenFileDialog(std::string&, const std::vector<std::pair<const char*, const char*>>&)
+{
+    return false;
+}
+
+//acknowledge atlas requests like a renderer backend would
+static void UpdateTextures()
+{
+    for (ImTextureData* tex : ImGui::GetPlatformIO().Textures)
+    {
+        if (tex->Status == ImTextureStatus_WantCreate || tex->Status == ImTextureStatus_WantUpdates) {
+            tex->SetTexID((ImTextureID)(intptr_t)(tex->UniqueID + 1));
+            tex->SetStatus(ImTextureStatus_OK);
+        }
+        else if (tex->Status == ImTextureStatus_WantDestroy && tex->UnusedFrames > 0) {
+            tex->SetTexID(ImTextureID_Invalid);
+            tex->SetStatus(ImTextureStatus_Destroyed);
+        }
+    }
+}
+
+void InitHeadless(UIContext& ctx)
+{
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = { 1920, 1080 };
+    io.DeltaTime = 1.f / 60;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable; //dockspace shape
+    ImFont* font = io.Fonts->AddFontDefault();
+
+    ctx.style = ImGui::GetStyle();
+    ctx.appStyle = &ImGui::GetStyle();
+    ctx.defaultStyleFont = ctx.pgFont = ctx.pgbFont = font;
+    ctx.fontNames = { "" };
+    stx::fill(ctx.colors, IM_COL32(255, 0, 255, 255));
+    ctx.designAreaMin = { 0, 0 };
+    ctx.designAreaMax = io.DisplaySize;
+    ctx.unit = "px";
+}
+
+void ShutdownHeadless()
+{
+    ImGui::DestroyContext();
+}
+
+void DrawHeadless(UINode* root, UIContext& ctx)
+{
+    ImGui::NewFrame();
+    ImGui::PushFont(ctx.defaultStyleFont);
+    ctx.drawCache.Invalidate(); //measure the full redraw
+    root->Draw(ctx);
+    ImGui::PopFont();
+    ImGui::Render();
+    UpdateTextures();
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "uicontext.h"
+
+//Headless environment for tools linking imrad_core.
+//The font atlas is built in memory and textures are never uploaded so designs
+//can be drawn without a window or GPU. Also provides the platform services
+//the application implements with nfd and OpenGL
+void InitHeadless(UIContext& ctx);
+void ShutdownHeadless();
+//one complete ImGui frame drawing the design the same way the designer does
+void DrawHeadless(UINode* root, UIContext& ctx);
@@ -0,0 +1,224 @@
+#include "headless.h"
+#include "synthetic.h"
+#include "cppgen.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+//Round-trip regression suite over generated designs.
+//Each shape is generated and exported, then timed through
+//import -> draw -> export -> re-import -> export and both exports are compared
+//with the original files. Results go to a JSON report, exit code is nonzero
+//when a round-trip is not byte stable.
+//usage: imrad_roundtrip [--out report.json] [--dir path] [--scale F] [--frames N]
+
+struct Result
+{
+    DesignShape shape;
+    size_t bytes = 0;
+    int nodes = 0;
+    double generateMs = 0;
+    double importMs = 0;
+    double drawMs = 0;
+    double exportMs = 0;
+    double reimportMs = 0;
+    double reexportMs = 0;
+    int diffLine = 0; //first line differing from the original, 0 when stable
+    std::string error;
+};
+
+template <class F>
+static double Measure(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string ReadFile(const fs::path& path)
+{
+    std::ifstream fin(path, std::ios::binary);
+    std::ostringstream os;
+    os << fin.rdbuf();
+    return os.str();
+}
+
+static int FirstDiffLine(const std::string& a, const std::string& b)
+{
+    if (a == b)
+        return 0;
+    size_t n = std::min(a.size(), b.size());
+    size_t i = 0;
+    while (i < n && a[i] == b[i])
+        ++i;
+    return 1 + (int)std::count(a.begin(), a.begin() + i, '\n');
+}
+
+static std::vector<std::unique_ptr<TopWindow>> ImportDesign(CppGen& codeGen, const std::string& fname, std::vector<CppGen::Config>& configs, std::string& err)
+{
+    configs = codeGen.Import(fname, err);
+    std::vector<std::unique_ptr<TopWindow>> roots;
+    for (const auto& cfg : configs)
+        roots.emplace_back(cfg.node);
+    return roots;
+}
+
+static void Run(Result& res, int frames, const fs::path& dir, UIContext& ctx)
+{
+    const DesignShape& shape = res.shape;
+    std::string fname = u8string(dir / (shape.name + ".h"));
+    auto cpath = u8path(fname).replace_extension(".cpp");
+    std::string err;
+    res.generateMs = Measure([&] {
+        if (!WriteDesign(fname, shape, ctx, err))
+            res.error = err;
+        });
+    if (res.error != "")
+        return;
+    std::string origH = ReadFile(u8path(fname));
+    std::string origCpp = ReadFile(cpath);
+    res.bytes = origH.size() + origCpp.size();
+
+    CppGen codeGen;
+    std::vector<CppGen::Config> configs;
+    std::vector<std::unique_ptr<TopWindow>> roots;
+    err = "";
+    res.importMs = Measure([&] { roots = ImportDesign(codeGen, fname, configs, err); });
+    if (roots.empty()) {
+        res.error = "import failed: " + err;
+        return;
+    }
+    for (const auto& root : roots)
+        res.nodes += (int)root->GetAllChildren().size();
+
+    ctx.codeGen = &codeGen;
+    ctx.allRoots.clear();
+    for (const auto& root : roots)
+        ctx.allRoots.push_back(root.get());
+    res.drawMs = Measure([&] {
+        for (int i = 0; i < frames; ++i)
+            DrawHeadless(roots[0].get(), ctx);
+        }) / frames;
+    ctx.allRoots.clear();
+    ctx.selected.clear();
+
+    err = "";
+    res.exportMs = Measure([&] { codeGen.ExportUpdate(fname, configs, err); });
+    res.diffLine = FirstDiffLine(origH + origCpp, ReadFile(u8path(fname)) + ReadFile(cpath));
+
+    CppGen codeGen2;
+    std::vector<CppGen::Config> configs2;
+    roots.clear();
+    ctx.codeGen = &codeGen2;
+    err = "";
+    res.reimportMs = Measure([&] { roots = ImportDesign(codeGen2, fname, configs2, err); });
+    if (roots.empty()) {
+        res.error = "re-import failed: " + err;
+        ctx.codeGen = nullptr;
+        return;
+    }
+    err = "";
+    res.reexportMs = Measure([&] { codeGen2.ExportUpdate(fname, configs2, err); });
+    if (!res.diffLine)
+        res.diffLine = FirstDiffLine(origH + origCpp, ReadFile(u8path(fname)) + ReadFile(cpath));
+    ctx.codeGen = nullptr;
+}
+
+static std::string JsonEscape(const std::string& str)
+{
+    std::string ret;
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            ret += '\\';
+        if (c == '\n')
+            ret += "\\n";
+        else if ((unsigned char)c >= 0x20)
+            ret += c;
+    }
+    return ret;
+}
+
+static void WriteReport(std::ostream& os, const std::vector<Result>& results)
+{
+    os << "{\n";
+    os << "  \"version\": \"" << IMRAD_VERSION << "\",\n";
+    os << "  \"shapes\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        os << "    {\n";
+        os << "      \"name\": \"" << r.shape.name << "\",\n";
+        os << "      \"widgets\": " << r.shape.widgets << ",\n";
+        os << "      \"configs\": " << r.shape.configs << ",\n";
+        os << "      \"nodes\": " << r.nodes << ",\n";
+        os << "      \"bytes\": " << r.bytes << ",\n";
+        os << "      \"generate_ms\": " << r.generateMs << ",\n";
+        os << "      \"import_ms\": " << r.importMs << ",\n";
+        os << "      \"draw_ms\": " << r.drawMs << ",\n";
+        os << "      \"export_ms\": " << r.exportMs << ",\n";
+        os << "      \"reimport_ms\": " << r.reimportMs << ",\n";
+        os << "      \"reexport_ms\": " << r.reexportMs << ",\n";
+        os << "      \"stable\": " << (r.error == "" && !r.diffLine ? "true" : "false") << ",\n";
+        os << "      \"diff_line\": " << r.diffLine << ",\n";
+        os << "      \"error\": \"" << JsonEscape(r.error) << "\"\n";
+        os << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n";
+    os << "}\n";
+}
+
+int main(int argc, const char* argv[])
+{
+    std::string out;
+    fs::path dir = fs::temp_directory_path() / "imrad_roundtrip";
+    float scale = 1;
+    int frames = 5;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!std::strcmp(argv[i], "--out"))
+            out = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--dir"))
+            dir = u8path(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--scale"))
+            scale = (float)std::atof(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--frames"))
+            frames = std::max(1, std::atoi(argv[i + 1]));
+    }
+    std::error_code err;
+    fs::create_directories(dir, err);
+
+    UIContext ctx;
+    InitHeadless(ctx);
+    std::vector<Result> results;
+    bool stable = true;
+    for (const auto& shape : DefaultShapes(scale))
+    {
+        Result& res = results.emplace_back();
+        res.shape = shape;
+        Run(res, frames, dir, ctx);
+        std::string status = "stable";
+        if (res.error != "")
+            status = res.error;
+        else if (res.diffLine)
+            status = "differs at line " + std::to_string(res.diffLine);
+        std::fprintf(stderr, "%-12s %8d nodes  import %9.2f ms  draw %9.2f ms  export %9.2f ms  %s\n",
+            shape.name.c_str(), res.nodes, res.importMs, res.drawMs, res.exportMs, status.c_str());
+        if (status != "stable")
+            stable = false;
+    }
+    ShutdownHeadless();
+
+    if (out != "") {
+        std::ofstream fout(u8path(out));
+        WriteReport(fout, results);
+    }
+    else {
+        WriteReport(std::cout, results);
+    }
+    return stable ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+#include "synthetic.h"
+#include "node_container.h"
+#include "node_extra.h"
+#include "cppgen.h"
+#include "utils.h"
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+static const std::array<const char*, 10> LEAF_TYPES{
+    "Text", "Button", "CheckBox", "Input", "Combo",
+    "Slider", "Selectable", "ProgressBar", "ColorEdit", "Separator",
+};
+static const std::array<const char*, 3> CONTAINER_TYPES{
+    "Child", "CollapsingHeader", "TreeNode",
+};
+const int TABLE_ROWS = 8;
+
+std::vector<DesignShape> DefaultShapes(float scale)
+{
+    auto count = [scale](int n) { return std::max(1, int(n * scale)); };
+    std::vector<DesignShape> shapes(7);
+    shapes[0].name = "flat";
+    shapes[0].widgets = count(2000);
+    shapes[0].depth = 1;
+    shapes[1].name = "deep";
+    shapes[1].widgets = count(2000);
+    shapes[1].depth = 32;
+    shapes[1].fanout = 3;
+    shapes[2].name = "wide_table";
+    shapes[2].widgets = count(4000);
+    shapes[2].depth = 2;
+    shapes[2].tableColumns = 64;
+    shapes[3].name = "configs";
+    shapes[3].widgets = count(500);
+    shapes[3].configs = 8;
+    shapes[4].name = "bindings";
+    shapes[4].widgets = count(2000);
+    shapes[4].bindings = true;
+    shapes[5].name = "user_code";
+    shapes[5].widgets = count(500);
+    shapes[5].userCodeLines = count(20000);
+    shapes[6].name = "dockspace";
+    shapes[6].widgets = count(500);
+    shapes[6].dockNodes = 12;
+    return shapes;
+}
+
+static std::unique_ptr<Widget> CreateTable(int columns, UIContext& ctx)
+{
+    auto table = std::make_unique<Table>(ctx);
+    table->columnData.clear();
+    for (int i = 0; i < columns; ++i)
+        table->columnData.emplace_back("C" + std::to_string(i), ImGuiTableColumnFlags_WidthStretch);
+    return table;
+}
+
+//odd nodes are nested in the previous one and get a bound ratio like std::min(a,b)
+//so MakeDockLayout entries contain commas inside a field
+static std::unique_ptr<Widget> CreateDockSpace(int nodes, UIContext& ctx)
+{
+    auto dock = std::make_unique<DockSpace>(ctx);
+    DockNode* prev = nullptr;
+    for (int i = 0; i < nodes; ++i)
+    {
+        auto node = std::make_unique<DockNode>(ctx);
+        node->splitDir = ImGuiDir(i % 4);
+        node->labels = "Window" + std::to_string(i) + "\nTools, " + std::to_string(i);
+        if (i % 2) {
+            std::string var = ctx.codeGen->CreateVar("float", "0.3f", CppGen::Var::Interface);
+            node->splitRatio.set_from_arg("std::min(" + var + ",0.5f)");
+        }
+        else
+            node->splitRatio = 0.2f + 0.05f * (i % 5);
+        DockNode* tmp = node.get();
+        if (i % 2 && prev)
+            prev->children.push_back(std::move(node));
+        else
+            dock->children.push_back(std::move(node));
+        prev = tmp;
+    }
+    return dock;
+}
+
+static void Fill(UINode* parent, int depth, int& remaining, const DesignShape& shape, UIContext& ctx)
+{
+    bool inTable = dynamic_cast<Table*>(parent);
+    int fanout = inTable ? shape.tableColumns * TABLE_ROWS : shape.fanout;
+    for (int i = 0; i < fanout && remaining > 0; ++i)
+    {
+        //every 5th and the last child opens a container
+        bool container = !inTable && depth < shape.depth && (i % 5 == 4 || i == fanout - 1);
+        std::unique_ptr<Widget> wdg;
+        if (container && shape.tableColumns)
+            wdg = CreateTable(shape.tableColumns, ctx);
+        else if (container)
+            wdg = Widget::Create(CONTAINER_TYPES[(depth + i) % CONTAINER_TYPES.size()], ctx);
+        else
+            wdg = Widget::Create(LEAF_TYPES[remaining % LEAF_TYPES.size()], ctx);
+        --remaining;
+        if (inTable && i)
+            wdg->nextColumn = 1;
+        if (shape.bindings) {
+            wdg->visible.set_from_arg(ctx.codeGen->CreateVar("bool", "true", CppGen::Var::Interface));
+            wdg->disabled.set_from_arg(ctx.codeGen->CreateVar("bool", "false", CppGen::Var::Interface));
+        }
+        UINode* node = wdg.get();
+        parent->children.push_back(std::move(wdg));
+        if (container)
+            Fill(node, depth + 1, remaining, shape, ctx);
+    }
+}
+
+std::unique_ptr<TopWindow> GenerateDesign(const DesignShape& shape, UIContext& ctx)
+{
+    ctx.kind = TopWindow::Window;
+    auto top = std::make_unique<TopWindow>(ctx);
+    int remaining = shape.widgets;
+    if (shape.dockNodes)
+        top->children.push_back(CreateDockSpace(shape.dockNodes, ctx));
+    while (remaining > 0)
+        Fill(top.get(), 1, remaining, shape, ctx);
+    return top;
+}
+
+bool WriteDesign(const std::string& fname, const DesignShape& shape, UIContext& ctx, std::string& err)
+{
+    auto hpath = u8path(fname).replace_extension(".h");
+    auto cpath = u8path(fname).replace_extension(".cpp");
+    std::error_code ec;
+    fs::remove(hpath, ec);
+    fs::remove(cpath, ec);
+
+    CppGen codeGen;
+    codeGen.SetNamesFromId(u8string(hpath.stem()));
+    CppGen* tmpCodeGen = ctx.codeGen;
+    ctx.codeGen = &codeGen;
+    std::vector<std::unique_ptr<TopWindow>> roots;
+    std::vector<CppGen::Config> configs;
+    for (int i = 0; i < shape.configs; ++i)
+    {
+        roots.push_back(GenerateDesign(shape, ctx));
+        CppGen::Config& cfg = configs.emplace_back();
+        cfg.name = i ? "Config" + std::to_string(i) : "";
+        cfg.node = roots.back().get();
+        cfg.params = { { "style", "Dark" }, { "unit", ctx.unit } };
+    }
+    bool ok = codeGen.ExportUpdate(fname, configs, err);
+    ctx.codeGen = tmpCodeGen;
+    if (!ok)
+        return false;
+
+    if (shape.userCodeLines)
+    {
+        std::ofstream fout(cpath, std::ios::app);
+        fout << "\nstatic int UserCode(int a)\n{\n";
+        for (int i = 0; i < shape.userCodeLines; ++i)
+            fout << "    a = a * " << (i % 7 + 2) << " + " << i << "; //line " << i << "\n";
+        fout << "    return a;\n}\n";
+        if (!fout) {
+            err = "can't write to '" + u8string(cpath) + "'";
+            return false;
+        }
+    }
+    return true;
+}
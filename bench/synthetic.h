@@ -0,0 +1,30 @@
+#pragma once
+#include "node_window.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+//Shape of a generated design.
+//Containers are nested up to depth levels and filled with a mix of common widgets
+//so layout, bindings and variable creation all get exercised
+struct DesignShape
+{
+    std::string name;
+    int widgets = 1000; //per configuration
+    int depth = 4;
+    int fanout = 10; //children per container
+    int tableColumns = 0; //use tables of this width as containers
+    int configs = 1;
+    bool bindings = false; //bind visible/disabled of every widget to a field
+    int userCodeLines = 0; //user code appended to the .cpp file
+    int dockNodes = 0; //DockSpace split into this many nodes, every other ratio is bound
+};
+
+//shapes used by imrad_roundtrip, widget counts are multiplied by scale
+auto DefaultShapes(float scale) -> std::vector<DesignShape>;
+
+//ctx.codeGen receives the created fields
+auto GenerateDesign(const DesignShape& shape, UIContext& ctx) -> std::unique_ptr<TopWindow>;
+
+//generates all configurations, exports them into fname (.h/.cpp) and appends user code
+bool WriteDesign(const std::string& fname, const DesignShape& shape, UIContext& ctx, std::string& err);
@@ -9,6 +9,10 @@ add_library(imgui STATIC
 	${IMGUI_HEADERS}
 	${IMGUI_MISC}
 	${IMGUI_FT}
+)
+
+# platform backends are kept apart so headless tools don't pull GLFW/OpenGL
+add_library(imgui_backends STATIC
 	${IMGUI_DIR}/backends/imgui_impl_opengl3.cpp
 	${IMGUI_DIR}/backends/imgui_impl_glfw.cpp
 )
@@ -23,7 +27,10 @@ include_directories(
     ${GLFW_INCLUDE_DIR})
     
 target_link_libraries(imgui
-    freetype
+    freetype)
+
+target_link_libraries(imgui_backends
+    imgui
     ${OPENGL_LIBRARIES}
     ${GLFW_LIBRARIES})
     
@@ -1,5 +1,6 @@
 #pragma once
 #include <array>
+#include <map>
 #include <optional>
 #include <imgui.h>
 #include <imgui_internal.h>
@@ -29,6 +30,56 @@ inline bool IsHighlighted(const std::string& id)
     return false;
 }
 
+//lists sorted GetVarExprs result inside an open combo
+//typed characters narrow the list by prefix which is kept per combo popup
+//returns clicked expression or nullptr
+inline const std::string* VarExprsUI(const std::vector<std::pair<std::string, std::string>>& vars, std::string_view selected)
+{
+    static std::map<ImGuiID, std::string> prefixes;
+    ImGuiID popupId = ImGui::GetCurrentWindow()->PopupId;
+    if (ImGui::IsWindowAppearing())
+    {
+        //closed popups can't be detected from here, entries are dropped when another opens
+        //so besides open popups the map keeps at most the last closed one
+        for (auto it = prefixes.begin(); it != prefixes.end(); )
+        {
+            if (it->first != popupId && !ImGui::IsPopupOpen(it->first, 0))
+                it = prefixes.erase(it);
+            else
+                ++it;
+        }
+    }
+    std::string& prefix = prefixes[popupId];
+    if (ImGui::IsWindowAppearing())
+        prefix.clear();
+    if (ImGui::IsWindowFocused())
+    {
+        for (ImWchar c : ImGui::GetIO().InputQueueCharacters) {
+            if (c > ' ' && c < 0x80)
+                prefix += (char)c;
+        }
+        if (prefix.size() && ImGui::IsKeyPressed(ImGuiKey_Backspace))
+            prefix.pop_back();
+    }
+    if (prefix.size())
+        ImGui::TextDisabled("%s", prefix.c_str());
+
+    const std::string* clicked = nullptr;
+    auto range = CppGen::FilterVarExprs(vars, prefix);
+    ImGuiListClipper clipper;
+    clipper.Begin(int(range.second - range.first));
+    while (clipper.Step())
+    {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            const auto& v = vars[range.first + i];
+            if (ImGui::Selectable(v.first.c_str(), v.first == selected))
+                clicked = &v.first;
+        }
+    }
+    return clicked;
+}
+
 enum {
     BindingButton_ReferenceOnly = 0x1
 };
@@ -521,9 +572,8 @@ inline bool InputBindable(bindable<T>* val, const std::string& type, int flags,
                 newFieldPopup.codeGen = ctx.codeGen;
                 newFieldPopup.varOldName = vars[0];
                 newFieldPopup.mode = NewFieldPopup::RenameField;
-                newFieldPopup.OpenPopup([val, roots = ctx.allRoots]{
-                    for (auto root : roots)
-                        root->RenameFieldVars(newFieldPopup.varOldName, newFieldPopup.varName);
+                newFieldPopup.OpenPopup([val, &ctx, roots = ctx.allRoots]{
+                    ctx.varUsage.Rename(roots, newFieldPopup.varOldName, newFieldPopup.varName);
                     });
             }
             ImGui::PopStyleColor();
@@ -542,20 +592,11 @@ inline bool InputBindable(bindable<T>* val, const std::string& type, int flags,
             ImGui::PopStyleColor();
 
             ImGui::Separator();
-            auto vars = ctx.codeGen->GetVarExprs(type, true, ctx.GetCurrentArray());
-            /*auto* dc = ImGui::GetCurrentWindow()->DrawList;
-            float sp = ImGui::CalcTextSize(" ").x;*/
-            for (const auto& v : vars)
+            const auto& vars = ctx.codeGen->GetVarExprs(type, true, ctx.GetCurrentArray());
+            if (const auto* expr = VarExprsUI(vars, *val->access()))
             {
-                if (ImGui::Selectable(v.first.c_str(), v.first == *val->access()))
-                {
-                    *val->access() = v.first;
-                    changed = true;
-                }
-                /*ImVec2 p = ImGui::GetCursorScreenPos();
-                p.x += sp;
-                p.y -= 0.5f * ImGui::GetTextLineHeight();
-                dc->AddCircleFilled(p, 0.2f * ImGui::GetFontSize(), 0xff000000);*/
+                *val->access() = *expr;
+                changed = true;
             }
 
             ImGui::EndCombo();
@@ -1018,13 +1059,10 @@ inline bool InputBindable(bindable<std::vector<std::string>>* val, UIContext& ct
         ImGui::Separator();
         const auto& vars = ctx.codeGen->GetVarExprs("std::vector<std::string>", true, ctx.GetCurrentArray());
         std::string usedVar = val->has_single_variable() ? val->used_variables()[0] : "";
-        for (const auto& v : vars)
+        if (const auto* expr = VarExprsUI(vars, usedVar))
         {
-            if (ImGui::Selectable(v.first.c_str(), v.first == usedVar))
-            {
-                *val->access() = '{' + v.first + '}';
-                changed = true;
-            }
+            *val->access() = '{' + *expr + '}';
+            changed = true;
         }
         ImGui::EndCombo();
     }
@@ -1153,9 +1191,8 @@ inline bool InputFieldRef(field_ref<T>* val, const std::string& type, bool allow
             newFieldPopup.codeGen = ctx.codeGen;
             newFieldPopup.varOldName = vars[0];
             newFieldPopup.mode = NewFieldPopup::RenameField;
-            newFieldPopup.OpenPopup([val, roots=ctx.allRoots] {
-                for (auto root : roots)
-                    root->RenameFieldVars(newFieldPopup.varOldName, newFieldPopup.varName);
+            newFieldPopup.OpenPopup([val, &ctx, roots=ctx.allRoots] {
+                ctx.varUsage.Rename(roots, newFieldPopup.varOldName, newFieldPopup.varName);
                 });
         }
         ImGui::PopStyleColor();
@@ -1174,14 +1211,11 @@ inline bool InputFieldRef(field_ref<T>* val, const std::string& type, bool allow
         ImGui::PopStyleColor();
 
         ImGui::Separator();
-        auto vars = ctx.codeGen->GetVarExprs(type, true, ctx.GetCurrentArray());
-        for (const auto& v : vars)
+        const auto& vars = ctx.codeGen->GetVarExprs(type, true, ctx.GetCurrentArray());
+        if (const auto* expr = VarExprsUI(vars, *val->access()))
         {
-            if (ImGui::Selectable(v.first.c_str(), v.first == *val->access()))
-            {
-                *val->access() = v.first;
-                changed = true;
-            }
+            *val->access() = *expr;
+            changed = true;
         }
 
         ImGui::EndCombo();
@@ -1249,13 +1283,10 @@ inline bool InputDataSize(bindable<int>* val, bool allowEmpty, UIContext& ctx)
 
         ImGui::Separator();
         const auto& vars = ctx.codeGen->GetVarExprs("int", false);
-        for (const auto& v : vars)
+        if (const auto* expr = VarExprsUI(vars, val->display_string()))
         {
-            if (ImGui::Selectable(v.first.c_str(), v.first == val->display_string()))
-            {
-                *val->access() = v.first;
-                changed = true;
-            }
+            *val->access() = *expr;
+            changed = true;
         }
 
         ImGui::EndCombo();
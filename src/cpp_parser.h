@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <sstream>
+#include <streambuf>
+#include <string_view>
 #include <cctype>
 #include <array>
 
@@ -62,6 +64,47 @@ namespace cpp
             s == "unsigned char" || s == "char*" || s == "bool";
     }
 
+    //read-only istream over existing memory
+    //unlike istringstream it doesn't copy the buffer so stream positions
+    //can be used as offsets into the original string
+    struct view_streambuf : std::streambuf
+    {
+        view_streambuf(std::string_view s)
+        {
+            char* p = const_cast<char*>(s.data());
+            setg(p, p, p + s.size());
+        }
+
+    protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+        {
+            if (!(which & std::ios_base::in))
+                return pos_type(off_type(-1));
+            off_type base = dir == std::ios_base::beg ? 0 :
+                dir == std::ios_base::cur ? gptr() - eback() : egptr() - eback();
+            if (base + off < 0 || base + off > egptr() - eback())
+                return pos_type(off_type(-1));
+            setg(eback(), eback() + base + off, egptr());
+            return pos_type(base + off);
+        }
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+
+    struct view_istream : std::istream
+    {
+        view_istream(std::string_view s)
+            : std::istream(nullptr), buf(s)
+        {
+            rdbuf(&buf);
+        }
+
+    private:
+        view_streambuf buf;
+    };
+
     struct token_iterator
     {
         token_iterator()
@@ -708,33 +751,23 @@ namespace cpp
     //replaces identifier but ignores strings, preprocessor
     inline void replace_id(std::string& code, std::string_view old, std::string news)
     {
-        std::istringstream in(code);
-        std::streampos pos = 0;
+        view_istream in(code);
+        std::streamoff pos = 0;
         std::string out;
-        std::string buf;
+        out.reserve(code.size());
         for (token_iterator iter(in); iter != token_iterator(); ++iter)
         {
             if (*iter != old)
                 continue;
             //relies on token_iterator doing putback
-            auto n = in.tellg() - pos;
-            in.seekg(pos);
-            buf.resize(n - old.size());
-            in.read(buf.data(), buf.size());
-            out += buf;
-            in.ignore(old.size());
+            std::streamoff end = in.tellg();
+            out.append(code, pos, end - old.size() - pos);
             out += news;
-            pos += n;
+            pos = end;
         }
-        in.clear(); //clear EOF flag
-        in.seekg(0, std::ios::end);
-        auto n = in.tellg() - pos;
-        in.seekg(pos);
-        buf.resize(n);
-        in.read(buf.data(), n);
-        out += buf;
+        out.append(code, pos, std::string::npos);
 
-        code = out;
+        code = std::move(out);
     }
 
     //ImGui::GetStyle().Colors[alignment==0 ? ImGuiCol_X : ImGuiCol_Y] --> alignment, ImGuiCol_X, ImGuiCol_Y
@@ -928,12 +961,39 @@ namespace cpp
         std::string plural;
         std::string pvar;
     };
+    //removes ImRad::CallSite([]{}) argument which generated code passes to Translate
+    inline std::string strip_call_site(std::string_view str)
+    {
+        std::string tmp(str);
+        size_t i;
+        while ((i = tmp.find("ImRad::CallSite(")) != std::string::npos)
+        {
+            size_t j = i + 16;
+            for (int level = 1; j < tmp.size() && level; ++j) {
+                if (tmp[j] == '(')
+                    ++level;
+                else if (tmp[j] == ')')
+                    --level;
+            }
+            while (j < tmp.size() && (tmp[j] == ' ' || tmp[j] == ','))
+                ++j;
+            tmp.erase(i, j - i);
+        }
+        return tmp;
+    }
+
     inline parsed_str parse_str_arg(std::string_view str, bool directVar = false)
     {
         parsed_str r;
         parsed_str error;
         error.text = INVALID_TEXT;
 
+        std::string stripped;
+        if (str.find("ImRad::CallSite(") != std::string::npos) {
+            stripped = strip_call_site(str);
+            str = stripped;
+        }
+
         if (str == "0" || str == "NULL" || str == "nullptr")
         {
             return r;
@@ -1167,6 +1227,9 @@ namespace cpp
             os << "ImRad::VFormat(";
 
         os << "ImRad::Translate(";
+        //plural form depends on n so only singular strings are cached
+        if (plural == "")
+            os << "ImRad::CallSite([]{}), ";
         if (context != "")
             os << "\"" << context << "\", ";
         os << "\"" << rs.first << "\"";
@@ -3,6 +3,8 @@
 #include "stx.h"
 #include "utils.h"
 #include <fstream>
+#include <sstream>
+#include <iterator>
 #include <cctype>
 #include <set>
 
@@ -47,6 +49,51 @@ std::string DefaultInitFor(const std::string& stype)
     return "";
 }
 
+//reads the whole file in one block
+//last line is terminated with a new line as the parser expects
+std::string ReadFileContent(const fs::path& path)
+{
+    std::ifstream fin(path);
+    if (!fin)
+        return "";
+    std::string buf;
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    if (!ec)
+        buf.reserve(size + 1);
+    buf.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    if (buf.size() && buf.back() != '\n')
+        buf += '\n';
+    return buf;
+}
+
+//output is streamed into a temporary file which then replaces path
+//so a failed export leaves the previous file intact
+template <class F>
+static bool WriteFileStreamed(const fs::path& path, F&& write)
+{
+    fs::path tmp = path;
+    tmp += ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream fout(tmp, std::ios::trunc);
+        if (!fout)
+            return false;
+        write(fout);
+        if (!fout.flush()) {
+            fout.close();
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
 //----------------------------------------------------------------
 
 CppGen::CppGen()
@@ -153,17 +200,16 @@ bool CppGen::ExportUpdate(
         }
         CreateH(fout);
     }
-    std::ifstream fin(hpath);
-    std::string line;
-    std::stringstream fprev;
-    while (std::getline(fin, line))
-        fprev << line << "\n";
-    fin.close();
-    fprev.seekg(0);
-    std::ofstream fout(hpath, std::ios::trunc);
-    auto origNames = ExportH(fout, fprev, m_hname, configs);
+    std::string prev = ReadFileContent(hpath);
+    std::array<std::string, 3> origNames;
+    bool ok = WriteFileStreamed(hpath, [&](std::ostream& out) {
+        origNames = ExportH(out, prev, m_hname, configs);
+        });
     m_hname = u8string(hpath.filename());
-    fout.close();
+    if (!ok) {
+        err = "can't write to '" + hpath.string() + "'";
+        return false;
+    }
     err += m_error;
 
     //export .cpp
@@ -178,15 +224,15 @@ bool CppGen::ExportUpdate(
         }
         CreateCpp(fout);
     }
-    fin.open(fpath);
-    fprev.str("");
-    fprev.clear();
-    while (std::getline(fin, line))
-        fprev << line << "\n";
-    fin.close();
-    fprev.seekg(0);
-    fout.open(fpath, std::ios::trunc);
-    ExportCpp(fout, fprev, origNames, configs, drawCode);
+    prev = ReadFileContent(fpath);
+    //merged code goes straight to the file, user code is only copied from prev
+    ok = WriteFileStreamed(fpath, [&](std::ostream& out) {
+        ExportCpp(out, prev, origNames, configs, drawCode);
+        });
+    if (!ok) {
+        err = "can't write to '" + fpath.string() + "'";
+        return false;
+    }
     err += m_error;
     return true;
 }
@@ -223,11 +269,11 @@ void CppGen::CreateCpp(std::ostream& out)
     out << m_name << " " << m_vname << ";\n\n";
 }
 
-//follows fprev and overwrites generated members/functions only
+//follows prev and overwrites generated members/functions only
 std::array<std::string, 3>
 CppGen::ExportH(
     std::ostream& fout,
-    std::istream& fprev,
+    std::string_view prev,
     const std::string& origHName,
     const std::vector<Config>& configs
 )
@@ -238,25 +284,23 @@ CppGen::ExportH(
     bool first_include = true;
     int skip_to_level = -1;
     std::vector<std::string> line;
-    std::streampos fpos = 0;
+    std::streamoff fpos = 0;
     std::string ignore_section = "";
     std::string className;
     std::string origName, origVName;
     std::stringstream out;
     bool hasLayout = GetLayoutVars().size();
 
+    cpp::view_istream fprev(prev);
+
     //xpos == 0 => copy until current position
     //xpos > 0 => copy until xpos
     //xpos < 0 => copy except last xpos characters
+    //untouched code is written straight from the prev buffer
     auto copy_content = [&](int xpos = 0) {
-        int pos = (int)fprev.tellg();
-        int ignore_last = xpos < 0 ? -xpos : xpos > 0 ? pos - xpos : 0;
-        std::string buf;
-        fprev.seekg(fpos);
-        buf.resize(pos - fpos - ignore_last);
-        fprev.read(buf.data(), buf.size());
-        out.write(buf.data(), buf.size());
-        fprev.ignore(ignore_last);
+        std::streamoff pos = fprev.tellg();
+        std::streamoff ignore_last = xpos < 0 ? -xpos : xpos > 0 ? pos - xpos : 0;
+        out.write(prev.data() + fpos, pos - fpos - ignore_last);
         fpos = pos;
     };
 
@@ -561,26 +605,34 @@ CppGen::ExportH(
     }
 
     //copy remaining code
-    fprev.clear(); //clear EOF flag
-    fprev.seekg(0, std::ios::end);
-    copy_content();
+    out.write(prev.data() + fpos, prev.size() - fpos);
 
     //replace class name
     //todo: why is second pass required
-    std::string code = out.str();
-    cpp::replace_id(code, origName, m_name);
-    cpp::replace_id(code, origVName, m_vname);
-
-    //flush
-    fout << code;
+    bool rename = origName != "" && origName != m_name;
+    bool vrename = origVName != "" && origVName != m_vname;
+    if (rename || vrename)
+    {
+        std::string code = out.str();
+        if (rename)
+            cpp::replace_id(code, origName, m_name);
+        if (vrename)
+            cpp::replace_id(code, origVName, m_vname);
+        fout << code;
+    }
+    else if (out.tellp() > 0)
+    {
+        //flush without copying the buffer into a string
+        fout << out.rdbuf();
+    }
     return { origName, origVName, origHName };
 }
 
-//follows fprev and overwrites generated members/functions only
+//follows prev and overwrites generated members/functions only
 void
 CppGen::ExportCpp(
     std::ostream& fout,
-    std::istream& fprev,
+    std::string_view prev,
     const std::array<std::string, 3>& origNames, //name, vname, old header name
     const std::vector<Config>& configs,
     const std::vector<std::string>& drawCode
@@ -591,21 +643,19 @@ CppGen::ExportCpp(
     int comment_to_level = -1;
     bool preamble = true;
     std::vector<std::string> line;
-    std::streampos fpos = 0;
+    std::streamoff fpos = 0;
     std::set<std::string> funs;
 
+    cpp::view_istream fprev(prev);
+
     //xpos == 0 => copy until current position
     //xpos > 0 => copy until xpos
     //xpos < 0 => copy except last xpos characters
+    //untouched code is written straight from the prev buffer
     auto copy_content = [&](int xpos = 0) {
-        int pos = (int)fprev.tellg();
-        int ignore_last = xpos < 0 ? -xpos : xpos > 0 ? pos - xpos : 0;
-        std::string buf;
-        fprev.seekg(fpos);
-        buf.resize(pos - fpos - ignore_last);
-        fprev.read(buf.data(), buf.size());
-        fout.write(buf.data(), buf.size());
-        fprev.ignore(ignore_last);
+        std::streamoff pos = fprev.tellg();
+        std::streamoff ignore_last = xpos < 0 ? -xpos : xpos > 0 ? pos - xpos : 0;
+        fout.write(prev.data() + fpos, pos - fpos - ignore_last);
         fpos = pos;
     };
 
@@ -733,9 +783,7 @@ CppGen::ExportCpp(
     }
 
     //copy remaining code
-    fprev.clear(); //clear EOF flag
-    fprev.seekg(0, std::ios::end);
-    copy_content();
+    fout.write(prev.data() + fpos, prev.size() - fpos);
 
     //add missing spec members
     for (const auto& name : SPEC_FUN)
@@ -1083,11 +1131,13 @@ void CppGen::WriteDrawFun(std::ostream& fout, const std::string& id, const std::
 std::vector<CppGen::Config>
 CppGen::Import(
     const std::string& path,
-    std::string& err
+    std::string& err,
+    const std::set<std::string>& skipDrawFuns
 )
 {
     m_fields.clear();
     m_fields[""];
+    m_varExprs.clear();
     m_name = m_vname = "";
     m_error = "";
     ctx_workingDir = u8string(u8path(path).parent_path());
@@ -1100,7 +1150,7 @@ CppGen::Import(
     if (!fin)
         m_error += "Can't read " + u8string(fpath) + "\n";
     else
-        ImportCode(fin, m_hname);
+        ImportCode(fin, m_hname, {});
     fin.close();
 
     fpath = u8path(path).replace_extension("cpp");
@@ -1108,7 +1158,7 @@ CppGen::Import(
     if (!fin)
         m_error += "Can't read \"" + u8string(fpath) + "\"\n";
     else
-        configs = ImportCode(fin, u8string(fpath.filename()));
+        configs = ImportCode(fin, u8string(fpath.filename()), skipDrawFuns);
 
     if (m_name == "")
         m_error += "No window class found!\n";
@@ -1124,8 +1174,58 @@ CppGen::Import(
     return configs;
 }
 
+CppGen::ImportDigest
+CppGen::ReadImportDigest(const std::string& path)
+{
+    ImportDigest digest;
+    //header declares all fields and events, hash it as a whole
+    std::string code = ReadFileContent(u8path(path).replace_extension("h"));
+    digest.header = std::hash<std::string_view>()(code);
+
+    //from .cpp only the Draw functions with designer code are imported
+    code = ReadFileContent(u8path(path).replace_extension("cpp"));
+    cpp::view_istream is(code);
+    int level = 0;
+    bool design = false;
+    std::string name;
+    std::vector<std::string> line;
+    std::streamoff fpos = 0;
+    for (cpp::token_iterator iter(is); iter != cpp::token_iterator(); ++iter)
+    {
+        const std::string& tok = *iter;
+        if (tok == "{") {
+            if (!level++) {
+                name = IsMemFun(line);
+                if (name != "Draw" && name.compare(0, 5, "Draw_"))
+                    name = "";
+                design = false;
+                fpos = is.tellg();
+            }
+            line.clear();
+        }
+        else if (tok == "}") {
+            if (level && !--level && name != "" && design) {
+                std::streamoff pos = is.tellg();
+                std::string_view body(code.data() + fpos, (size_t)(pos - fpos));
+                digest.drawFuns[name] = std::hash<std::string_view>()(body);
+            }
+        }
+        else if (level) {
+            if (tok == "/// @begin TopWindow")
+                design = true;
+        }
+        else if (tok == ";") {
+            line.clear();
+        }
+        else if (tok[0] != '#' && tok.compare(0, 2, "//")) {
+            line.push_back(tok);
+        }
+    }
+    return digest;
+}
+
 std::vector<CppGen::Config>
-CppGen::ImportCode(std::istream& fin, const std::string& fname)
+CppGen::ImportCode(std::istream& fin, const std::string& fname, const std::set<std::string>& skipDrawFuns)
 {
     std::vector<Config> configs;
     cpp::token_iterator iter(fin);
@@ -1148,7 +1248,7 @@ CppGen::ImportCode(std::istream& fin, const std::string& fname)
             }
             else {
                 scope.push_back("");
-                auto cfg = ParseDrawFun(line, iter);
+                auto cfg = ParseDrawFun(line, iter, skipDrawFuns);
                 if (cfg)
                     configs.push_back(std::move(*cfg));
             }
@@ -1378,7 +1478,7 @@ std::string CppGen::IsMemFun(const std::vector<std::string>& line)
 }
 
 std::optional<CppGen::Config>
-CppGen::ParseDrawFun(const std::vector<std::string>& line, cpp::token_iterator& iter)
+CppGen::ParseDrawFun(const std::vector<std::string>& line, cpp::token_iterator& iter, const std::set<std::string>& skipDrawFuns)
 {
     Config cfg;
     std::string name = IsMemFun(line);
@@ -1389,6 +1489,12 @@ CppGen::ParseDrawFun(const std::vector<std::string>& line, cpp::token_iterator&
     else
         return {};
 
+    if (skipDrawFuns.count(name)) {
+        //caller keeps its current node, body is skipped by ImportCode
+        cfg.node = nullptr;
+        return cfg;
+    }
+
     auto pos1 = iter.stream().tellg();
     cpp::stmt_iterator sit(iter);
     int level = sit->level;
@@ -1453,6 +1559,7 @@ std::string CppType(const std::string& type)
 
 std::string CppGen::CreateVar(const std::string& type, const std::string& init, int flags, const std::string& scope)
 {
+    m_varExprs.clear();
     auto vit = m_fields.find(scope);
     if (vit == m_fields.end())
         return "";
@@ -1479,6 +1586,7 @@ std::string CppGen::CreateVar(const std::string& type, const std::string& init,
 
 bool CppGen::CreateNamedVar(const std::string& name, const std::string& type, const std::string& init, int flags, const std::string& scope)
 {
+    m_varExprs.clear();
     auto vit = m_fields.find(scope);
     if (vit == m_fields.end())
         return false;
@@ -1492,6 +1600,7 @@ bool CppGen::CreateNamedVar(const std::string& name, const std::string& type, co
 
 bool CppGen::RenameVar(const std::string& oldn, const std::string& newn, const std::string& scope)
 {
+    m_varExprs.clear();
     if (FindVar(newn, scope))
         return false;
     auto* var = FindVar(oldn, scope);
@@ -1503,6 +1612,7 @@ bool CppGen::RenameVar(const std::string& oldn, const std::string& newn, const s
 
 bool CppGen::RemoveVar(const std::string& name, const std::string& scope)
 {
+    m_varExprs.clear();
     auto vit = m_fields.find(scope);
     if (vit == m_fields.end())
         return false;
@@ -1515,6 +1625,7 @@ bool CppGen::RemoveVar(const std::string& name, const std::string& scope)
 
 void CppGen::RemovePrefixedVars(std::string_view prefix, std::string_view scope)
 {
+    m_varExprs.clear();
     auto vit = m_fields.find(std::string(scope));
     if (vit == m_fields.end())
         return;
@@ -1533,6 +1644,7 @@ void CppGen::RemovePrefixedVars(std::string_view prefix, std::string_view scope)
 
 bool CppGen::ChangeVar(const std::string& name, const std::string& type, const std::string& init, int flags, const std::string& scope)
 {
+    m_varExprs.clear();
     auto* var = FindVar(name, scope);
     if (!var)
         return false;
@@ -1572,6 +1684,7 @@ CppGen::GetVars(const std::string& scope)
 
 bool CppGen::RenameStruct(const std::string& oldn, const std::string& newn)
 {
+    m_varExprs.clear();
     if (newn == "" || newn == oldn || m_fields.count(newn))
         return false;
     auto it = m_fields.find(oldn);
@@ -1656,6 +1769,7 @@ CppGen::CheckVarExpr(const std::string& name, const std::string& type_, const st
 //accepts name patterns recognized by CheckVarExpr
 bool CppGen::CreateVarExpr(std::string& name, const std::string& type_, const std::string& init, int flags, const std::string& scope1)
 {
+    m_varExprs.clear();
     std::string type = CppType(type_);
     auto SingularUpperForm = [](const std::string& id) {
         std::string sing;
@@ -1741,13 +1855,21 @@ bool CppGen::CreateVarExpr(std::string& name, const std::string& type_, const st
     return true;
 }
 
-std::vector<std::pair<std::string, std::string>>
-CppGen::MatchType(const std::string& name, std::string_view type, std::string_view match, bool reference, const std::string& curArray)
+//expanding holds struct types on the current path so recursive types terminate
+void
+CppGen::MatchType(
+    const std::string& name,
+    std::string_view type,
+    std::string_view match,
+    bool reference,
+    const std::string& curArray,
+    std::vector<std::string_view>& expanding,
+    std::vector<std::pair<std::string, std::string>>& ret
+)
 {
-    std::vector<std::pair<std::string, std::string>> ret;
     if (!type.compare(0, 6, "const ")) {
         if (reference)
-            return ret;
+            return;
         type.remove_prefix(6);
     }
     if (type.size() && type.back() == '&')
@@ -1759,8 +1881,7 @@ CppGen::MatchType(const std::string& name, std::string_view type, std::string_vi
     std::string valueType, firstType, secondType;
     if (cpp::is_ptr(type, valueType))
     {
-        auto more = MatchType("*" + name, valueType, match, reference, curArray);
-        ret.insert(ret.end(), more.begin(), more.end());
+        MatchType("*" + name, valueType, match, reference, curArray, expanding, ret);
     }
     else if (cpp::is_std_container(type, valueType))
     {
@@ -1775,32 +1896,28 @@ CppGen::MatchType(const std::string& name, std::string_view type, std::string_vi
             i + curArray.size() == name.size() &&
             std::count(name.begin(), name.begin() + i, '*') == i)
         {
-            auto more = MatchType(CUR_ITEM_SYMBOL, valueType, match, reference, "");
-            ret.insert(ret.end(), more.begin(), more.end());
+            MatchType(CUR_ITEM_SYMBOL, valueType, match, reference, "", expanding, ret);
         }
     }
     else if (cpp::is_std_pair(type, firstType, secondType))
     {
         std::string pre = name[0]=='*' ? name.substr(1) + "->" : name + ".";
-        auto more = MatchType(pre + "first", firstType, match, reference, "");
-        ret.insert(ret.end(), more.begin(), more.end());
-        more = MatchType(pre + "second", secondType, match, reference, "");
-        ret.insert(ret.end(), more.begin(), more.end());
+        MatchType(pre + "first", firstType, match, reference, "", expanding, ret);
+        MatchType(pre + "second", secondType, match, reference, "", expanding, ret);
     }
     else
     {
         auto it = m_fields.find(std::string(type));
-        if (it == m_fields.end())
-            return ret;
+        if (it == m_fields.end() || stx::count(expanding, it->first))
+            return;
+        expanding.push_back(it->first);
         std::string pre = name[0]=='*' ? name.substr(1) + "->" : name + ".";
         for (const auto& f : it->second)
         {
-            auto more = MatchType(pre + f.name, f.type, match, reference, "");
-            ret.insert(ret.end(), more.begin(), more.end());
+            MatchType(pre + f.name, f.type, match, reference, "", expanding, ret);
         }
+        expanding.pop_back();
     }
-
-    return ret;
 }
 
 //type=="" accepts all variables
@@ -1809,18 +1926,37 @@ CppGen::MatchType(const std::string& name, std::string_view type, std::string_vi
 //type==void() accepts all functions of this type
 //reference only accepts lvalues
 //curArray accepts its array elements as well
-std::vector<std::pair<std::string, std::string>> //(name, type)
+//results are cached until the next variable change
+const std::vector<std::pair<std::string, std::string>>& //(name, type)
 CppGen::GetVarExprs(const std::string& type_, bool reference, const std::string& curArray)
 {
     assert(type_.find("const ") == std::string::npos && type_.find("&") == std::string::npos);
+    auto key = std::tuple{ type_, reference, curArray };
+    auto cit = m_varExprs.find(key);
+    if (cit != m_varExprs.end())
+        return cit->second;
+
     std::string type = CppType(type_);
     std::vector<std::pair<std::string, std::string>> ret;
+    std::vector<std::string_view> expanding;
     for (const auto& f : m_fields[""])
     {
-        auto match = MatchType(f.name, f.type, type, reference, curArray);
-        ret.insert(ret.end(), match.begin(), match.end());
+        MatchType(f.name, f.type, type, reference, curArray, expanding, ret);
     }
     stx::sort(ret);
-    return ret;
+    return m_varExprs.emplace(std::move(key), std::move(ret)).first->second;
+}
+
+std::pair<size_t, size_t>
+CppGen::FilterVarExprs(const std::vector<std::pair<std::string, std::string>>& vars, std::string_view prefix)
+{
+    auto first = std::lower_bound(vars.begin(), vars.end(), prefix, [](const auto& v, std::string_view p) {
+        return v.first < p;
+        });
+    auto last = first;
+    while (last != vars.end() && !last->first.compare(0, prefix.size(), prefix))
+        ++last;
+    return { first - vars.begin(), last - vars.begin() };
 }
 
+
@@ -2,6 +2,8 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
+#include <tuple>
 #include "node_window.h"
 
 //------------------------------------------------------
@@ -23,8 +25,21 @@ public:
         std::map<std::string, std::string> params;
     };
 
+    //hashes of the file parts the designer model is imported from
+    //edits outside of them (event handlers, user functions) don't require re-import
+    struct ImportDigest
+    {
+        size_t header = 0;
+        std::map<std::string, size_t> drawFuns; //Draw function name -> body hash
+
+        bool operator== (const ImportDigest& d) const { return header == d.header && drawFuns == d.drawFuns; }
+        bool operator!= (const ImportDigest& d) const { return !(*this == d); }
+    };
+
     bool ExportUpdate(const std::string& fname, const std::vector<Config>& configs, std::string& err);
-    auto Import(const std::string& path, std::string& err) -> std::vector<Config>;
+    //Draw functions listed in skipDrawFuns are not parsed and their Config::node is null
+    auto Import(const std::string& path, std::string& err, const std::set<std::string>& skipDrawFuns = {}) -> std::vector<Config>;
+    auto ReadImportDigest(const std::string& path) -> ImportDigest;
     int ReadGenVersion(const std::string& fname) const;
 
     const std::string& GetName() const { return m_name; }
@@ -59,27 +74,31 @@ public:
     enum VarExprResult { SyntaxError, ConflictError, Existing, New, New_ImplicitStruct };
     VarExprResult CheckVarExpr(const std::string& name, const std::string& type, const std::string& scope = "");
     bool CreateVarExpr(std::string& name, const std::string& type, const std::string& init, int flags, const std::string& scope = "");
-    auto GetVarExprs(const std::string& type, bool reference, const std::string& curArray = "") ->std::vector<std::pair<std::string, std::string>>;
+    //returned reference is valid until the next variable change
+    auto GetVarExprs(const std::string& type, bool reference, const std::string& curArray = "") -> const std::vector<std::pair<std::string, std::string>>&;
+    //[first, last) range of sorted GetVarExprs result starting with prefix
+    static auto FilterVarExprs(const std::vector<std::pair<std::string, std::string>>& vars, std::string_view prefix) -> std::pair<size_t, size_t>;
 
 private:
     Var* FindVar(const std::string& name, const std::string& scope);
-    auto MatchType(const std::string& name, std::string_view type, std::string_view match, bool reference, const std::string& curArray) -> std::vector<std::pair<std::string, std::string>>;
+    void MatchType(const std::string& name, std::string_view type, std::string_view match, bool reference, const std::string& curArray, std::vector<std::string_view>& expanding, std::vector<std::pair<std::string, std::string>>& ret);
 
     void CreateH(std::ostream& out);
     void CreateCpp(std::ostream& out);
-    auto ExportH(std::ostream& out, std::istream& prev, const std::string& origHName, const std::vector<Config>& configs) -> std::array<std::string, 3>;
-    void ExportCpp(std::ostream& out, std::istream& prev, const std::array<std::string, 3>& origNames, const std::vector<Config>& configs, const std::vector<std::string>& drawCode);
+    auto ExportH(std::ostream& out, std::string_view prev, const std::string& origHName, const std::vector<Config>& configs) -> std::array<std::string, 3>;
+    void ExportCpp(std::ostream& out, std::string_view prev, const std::array<std::string, 3>& origNames, const std::vector<Config>& configs, const std::vector<std::string>& drawCode);
     bool WriteStub(std::ostream& fout, const std::string& id, const std::vector<Config>& configs);
     void WriteDrawFun(std::ostream& fout, const std::string& id, const std::vector<Config>& configs, const std::string& code);
     void WriteForEachConfig(std::ostream& out, const std::vector<Config>& configs, std::function<std::string(const Config&)> fun);
-    auto ImportCode(std::istream& in, const std::string& fname) -> std::vector<Config>;
+    auto ImportCode(std::istream& in, const std::string& fname, const std::set<std::string>& skipDrawFuns) -> std::vector<Config>;
     auto GetDrawFunName(const std::string& cfgName, size_t size) -> std::string;
 
     bool ParseFieldDecl(const std::string& stype, const std::vector<std::string>& line, int flags);
     auto IsMemFun(const std::vector<std::string>& line)->std::string;
-    auto ParseDrawFun(const std::vector<std::string>& line, cpp::token_iterator& iter) -> std::optional<Config>;
+    auto ParseDrawFun(const std::vector<std::string>& line, cpp::token_iterator& iter, const std::set<std::string>& skipDrawFuns) -> std::optional<Config>;
 
     std::map<std::string, std::vector<Var>> m_fields;
+    std::map<std::tuple<std::string, bool, std::string>, std::vector<std::pair<std::string, std::string>>> m_varExprs;
     TopWindow::Kind m_kind;
     bool m_animate;
     std::string m_name, m_vname, m_hname;
@@ -0,0 +1,404 @@
+#include "file_watcher.h"
+#include "utils.h"
+#include "stx.h"
+#include <algorithm>
+#include <chrono>
+#if defined(WIN32)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <Windows.h>
+  #undef min
+  #undef max
+#elif !defined(__APPLE__)
+  #include <sys/inotify.h>
+  #include <poll.h>
+  #include <unistd.h>
+  #include <fcntl.h>
+  #include <errno.h>
+#endif
+
+FileWatcher fileWatcher;
+
+FileWatcher::~FileWatcher()
+{
+    Stop();
+}
+
+std::string FileWatcher::NormalPath(const std::string& path)
+{
+    fs::path p = u8path(path).lexically_normal();
+    //drop trailing separator so directories compare equal to their parent_path
+    if (!p.has_filename() && p.has_relative_path())
+        p = p.parent_path();
+    return u8string(p);
+}
+
+void FileWatcher::Watch(const std::string& path)
+{
+    if (!running || path == "")
+        return;
+    std::string npath = NormalPath(path);
+    std::error_code err;
+    bool isDir = fs::is_directory(u8path(npath), err);
+    std::string dir = isDir ? npath : u8string(u8path(npath).parent_path());
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& dw = dirs[dir];
+    if (!dw.dirRefs && dw.files.empty() && !AddDir(dir, dw)) {
+        dirs.erase(dir);
+        return;
+    }
+    if (isDir)
+        ++dw.dirRefs;
+    else
+        ++dw.files[u8string(u8path(npath).filename())];
+}
+
+void FileWatcher::Unwatch(const std::string& path)
+{
+    if (!running || path == "")
+        return;
+    std::string npath = NormalPath(path);
+    std::lock_guard<std::mutex> lock(mutex);
+    //path is a directory if it was registered as one
+    auto it = dirs.find(npath);
+    if (it != dirs.end() && it->second.dirRefs) {
+        --it->second.dirRefs;
+    }
+    else {
+        it = dirs.find(u8string(u8path(npath).parent_path()));
+        if (it == dirs.end())
+            return;
+        auto fit = it->second.files.find(u8string(u8path(npath).filename()));
+        if (fit == it->second.files.end())
+            return;
+        if (!--fit->second)
+            it->second.files.erase(fit);
+    }
+    if (!it->second.dirRefs && it->second.files.empty()) {
+        RemoveDir(it->second);
+        dirs.erase(it);
+    }
+}
+
+//called from the watcher thread with mutex locked
+void FileWatcher::AddChange(const std::string& dir, const DirWatch& dw, const std::string& name, std::vector<std::string>& changes)
+{
+    if (!dw.dirRefs && !dw.files.count(name))
+        return;
+    std::string path = u8string(u8path(dir) / u8path(name));
+    if (stx::count(changes, path))
+        return;
+    if (changes.empty())
+        firstChange = std::chrono::steady_clock::now();
+    changes.push_back(std::move(path));
+}
+
+//wait for the burst to settle but don't delay the first change indefinitely
+int FileWatcher::Timeout(const std::vector<std::string>& changes) const
+{
+    if (changes.empty())
+        return -1;
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - firstChange);
+    return std::max(0, std::min(DEBOUNCE_MS, 4 * DEBOUNCE_MS - (int)elapsed.count()));
+}
+
+#if defined(__APPLE__)
+
+bool FileWatcher::Start()
+{
+    return false;
+}
+
+void FileWatcher::Stop()
+{
+}
+
+bool FileWatcher::AddDir(const std::string&, DirWatch&)
+{
+    return false;
+}
+
+void FileWatcher::RemoveDir(DirWatch&)
+{
+}
+
+void FileWatcher::Run()
+{
+}
+
+#elif defined(WIN32)
+
+namespace {
+
+struct DirHandle
+{
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    OVERLAPPED ov = {};
+    std::vector<DWORD> buffer = std::vector<DWORD>(4096); //FILE_NOTIFY_INFORMATION is DWORD aligned
+
+    ~DirHandle()
+    {
+        if (handle != INVALID_HANDLE_VALUE) {
+            CancelIoEx(handle, &ov);
+            DWORD n;
+            GetOverlappedResult(handle, &ov, &n, TRUE);
+            CloseHandle(handle);
+        }
+        if (ov.hEvent)
+            CloseHandle(ov.hEvent);
+    }
+    bool Read()
+    {
+        return ReadDirectoryChangesW(
+            handle,
+            buffer.data(),
+            (DWORD)(buffer.size() * sizeof(DWORD)),
+            FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+            NULL,
+            &ov,
+            NULL
+        );
+    }
+};
+
+}
+
+bool FileWatcher::Start()
+{
+    if (running)
+        return true;
+    wakeup = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (!wakeup)
+        return false;
+    quit = false;
+    rescan = false;
+    running = true;
+    thread = std::thread([this] { Run(); });
+    return true;
+}
+
+void FileWatcher::Stop()
+{
+    if (!running)
+        return;
+    quit = true;
+    SetEvent(wakeup);
+    thread.join();
+    running = false;
+    CloseHandle(wakeup);
+    wakeup = nullptr;
+    dirs.clear();
+}
+
+//directory handles are owned by the watcher thread which reopens them on rescan
+bool FileWatcher::AddDir(const std::string&, DirWatch&)
+{
+    rescan = true;
+    SetEvent(wakeup);
+    return true;
+}
+
+void FileWatcher::RemoveDir(DirWatch&)
+{
+    rescan = true;
+    SetEvent(wakeup);
+}
+
+void FileWatcher::Run()
+{
+    std::map<std::string, std::unique_ptr<DirHandle>> open;
+    std::vector<std::string> changes;
+    std::vector<HANDLE> events;
+    std::vector<std::string> eventDirs;
+
+    while (!quit)
+    {
+        if (rescan.exchange(false))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto it = open.begin(); it != open.end(); ) {
+                if (dirs.count(it->first))
+                    ++it;
+                else
+                    it = open.erase(it);
+            }
+            for (const auto& dw : dirs)
+            {
+                if (open.count(dw.first) || open.size() + 1 >= MAXIMUM_WAIT_OBJECTS)
+                    continue;
+                auto dh = std::make_unique<DirHandle>();
+                dh->handle = CreateFileW(
+                    u8path(dw.first).wstring().c_str(),
+                    FILE_LIST_DIRECTORY,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                    NULL,
+                    OPEN_EXISTING,
+                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                    NULL
+                );
+                if (dh->handle == INVALID_HANDLE_VALUE)
+                    continue;
+                dh->ov.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+                if (!dh->ov.hEvent || !dh->Read())
+                    continue;
+                open[dw.first] = std::move(dh);
+            }
+        }
+
+        events.assign(1, (HANDLE)wakeup);
+        eventDirs.assign(1, "");
+        for (const auto& dh : open) {
+            events.push_back(dh.second->ov.hEvent);
+            eventDirs.push_back(dh.first);
+        }
+        int timeout = Timeout(changes);
+        DWORD ret = WaitForMultipleObjects((DWORD)events.size(), events.data(), FALSE, timeout < 0 ? INFINITE : (DWORD)timeout);
+        if (ret == WAIT_FAILED)
+            break;
+        if (ret == WAIT_TIMEOUT ||
+            (changes.size() && std::chrono::steady_clock::now() - firstChange >= std::chrono::milliseconds(4 * DEBOUNCE_MS))) {
+            Post(changes);
+            if (ret == WAIT_TIMEOUT)
+                continue;
+        }
+        size_t i = ret - WAIT_OBJECT_0;
+        if (!i || i >= events.size())
+            continue; //woken up for rescan or quit
+
+        const std::string& dir = eventDirs[i];
+        DirHandle& dh = *open[dir];
+        DWORD len = 0;
+        if (GetOverlappedResult(dh.handle, &dh.ov, &len, FALSE))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = dirs.find(dir);
+            if (!len) //buffer overflowed
+                overflow = true;
+            for (DWORD pos = 0; len && it != dirs.end(); )
+            {
+                const auto* fni = (const FILE_NOTIFY_INFORMATION*)((const char*)dh.buffer.data() + pos);
+                std::wstring wname(fni->FileName, fni->FileNameLength / sizeof(WCHAR));
+                AddChange(dir, it->second, u8string(fs::path(wname)), changes);
+                if (!fni->NextEntryOffset)
+                    break;
+                pos += fni->NextEntryOffset;
+            }
+        }
+        ResetEvent(dh.ov.hEvent);
+        if (!dh.Read())
+            open.erase(dir);
+    }
+}
+
+#else
+
+const uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+bool FileWatcher::Start()
+{
+    if (running)
+        return true;
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return false;
+    if (pipe(wakeup) < 0) {
+        close(fd);
+        fd = -1;
+        return false;
+    }
+    fcntl(wakeup[0], F_SETFD, FD_CLOEXEC);
+    fcntl(wakeup[1], F_SETFD, FD_CLOEXEC);
+    running = true;
+    thread = std::thread([this] { Run(); });
+    return true;
+}
+
+void FileWatcher::Stop()
+{
+    if (!running)
+        return;
+    char c = 0;
+    (void)!write(wakeup[1], &c, 1);
+    thread.join();
+    running = false;
+    close(wakeup[0]);
+    close(wakeup[1]);
+    close(fd); //removes all watches
+    wakeup[0] = wakeup[1] = fd = -1;
+    dirs.clear();
+}
+
+bool FileWatcher::AddDir(const std::string& dir, DirWatch& dw)
+{
+    dw.wd = inotify_add_watch(fd, u8path(dir).c_str(), WATCH_MASK);
+    return dw.wd >= 0;
+}
+
+void FileWatcher::RemoveDir(DirWatch& dw)
+{
+    inotify_rm_watch(fd, dw.wd);
+}
+
+void FileWatcher::Run()
+{
+    std::vector<char> buffer(64 * (sizeof(struct inotify_event) + 256));
+    std::vector<std::string> changes;
+    pollfd fds[2] = { { fd, POLLIN, 0 }, { wakeup[0], POLLIN, 0 } };
+
+    while (true)
+    {
+        int n = poll(fds, 2, Timeout(changes));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 || (fds[1].revents & POLLIN))
+            break;
+        if (!n || (changes.size() && std::chrono::steady_clock::now() - firstChange >= std::chrono::milliseconds(4 * DEBOUNCE_MS))) {
+            Post(changes);
+            if (!n)
+                continue;
+        }
+
+        ssize_t len;
+        while ((len = read(fd, buffer.data(), buffer.size())) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (ssize_t i = 0; i < len; )
+            {
+                const auto* ev = (const struct inotify_event*)(buffer.data() + i);
+                i += sizeof(struct inotify_event) + ev->len;
+                if (ev->mask & IN_Q_OVERFLOW) {
+                    overflow = true;
+                    continue;
+                }
+                if (!ev->len)
+                    continue;
+                auto it = stx::find_if(dirs, [&](const auto& d) { return d.second.wd == ev->wd; });
+                if (it == dirs.end())
+                    continue;
+                AddChange(it->first, it->second, ev->name, changes);
+            }
+        }
+    }
+}
+
+#endif
+
+void FileWatcher::Post(std::vector<std::string>& changes)
+{
+    for (auto& path : changes) {
+        if (!queue.push(std::move(path)))
+            overflow = true;
+    }
+    changes.clear();
+}
+
+bool FileWatcher::PopChange(std::string& path)
+{
+    if (overflow.exchange(false)) {
+        path = "";
+        return true;
+    }
+    return queue.pop(path);
+}
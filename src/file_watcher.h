@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+//single producer single consumer ring buffer
+//used to hand watcher events to the UI thread without locking
+template <class T, size_t N>
+class SpscQueue
+{
+public:
+    bool push(T&& val)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) % N;
+        if (next == head.load(std::memory_order_acquire))
+            return false;
+        buffer[t] = std::move(val);
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+    bool pop(T& val)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        val = std::move(buffer[h]);
+        head.store((h + 1) % N, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, N> buffer;
+    std::atomic<size_t> head{ 0 };
+    std::atomic<size_t> tail{ 0 };
+};
+
+//Watches files and directories for changes from a background thread.
+//Bursts of events are coalesced within DEBOUNCE_MS and delivered through PopChange.
+//Watching a file covers editors which save by renaming a temporary file over it.
+//Implemented with inotify and ReadDirectoryChangesW, Active() returns false elsewhere
+//and callers fall back to polling last_write_time
+class FileWatcher
+{
+public:
+    static const int DEBOUNCE_MS = 150;
+
+    ~FileWatcher();
+    bool Start();
+    void Stop();
+    bool Active() const { return running; }
+    //watches are reference counted
+    void Watch(const std::string& path);
+    void Unwatch(const std::string& path);
+    //returns normalized path of the changed file
+    //overflow is reported as empty path meaning everything needs to be rechecked
+    bool PopChange(std::string& path);
+
+    static std::string NormalPath(const std::string& path);
+
+private:
+    struct DirWatch {
+        int wd = -1;
+        int dirRefs = 0; //whole directory watched
+        std::map<std::string, int> files; //file name -> refs
+    };
+    void Run();
+    bool AddDir(const std::string& dir, DirWatch& dw);
+    void RemoveDir(DirWatch& dw);
+    void AddChange(const std::string& dir, const DirWatch& dw, const std::string& name, std::vector<std::string>& changes);
+    int Timeout(const std::vector<std::string>& changes) const;
+    void Post(std::vector<std::string>& changes);
+
+    std::map<std::string, DirWatch> dirs;
+    std::mutex mutex;
+    std::thread thread;
+    bool running = false;
+#ifdef WIN32
+    void* wakeup = nullptr; //auto-reset event HANDLE
+    std::atomic<bool> rescan{ false }; //dirs changed
+    std::atomic<bool> quit{ false };
+#else
+    int fd = -1;
+    int wakeup[2] = { -1, -1 };
+#endif
+    std::chrono::steady_clock::time_point firstChange;
+    std::atomic<bool> overflow{ false };
+    SpscQueue<std::string, 256> queue;
+};
+
+extern FileWatcher fileWatcher;
@@ -8,7 +8,6 @@
   #include <mach-o/dyld.h>
 #else //linux
   #include <sys/types.h>
-  #include <sys/inotify.h>
 #endif
 #include <imgui.h>
 #include <imgui_internal.h>
@@ -47,6 +46,8 @@
 #include "ui_configuration_dlg.h"
 #include "ui_new_style.h"
 #include "ui_text_edit.h"
+#include "file_watcher.h"
+#include "texture_cache.h"
 
 #define IMRAD_H_IMPLEMENTATION
 #include "imrad.h"
@@ -60,6 +61,42 @@ static void glfw_error_callback(int error, const char* description)
     std::cerr << "ERROR: " << description << std::endl;
 }
 
+ImTextureID UploadTexture(const unsigned char* rgba, int w, int h)
+{
+    GLuint id;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+#if defined(GL_UNPACK_ROW_LENGTH) && !defined(__EMSCRIPTEN__)
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+#endif
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    return (ImTextureID)(intptr_t)id;
+}
+
+void DeleteTexture(ImTextureID texId)
+{
+    GLuint id = (GLuint)(intptr_t)texId;
+    glDeleteTextures(1, &id);
+}
+
+bool OpenFileDialog(std::string& path, const std::vector<std::pair<const char*, const char*>>& filters)
+{
+    std::vector<nfdfilteritem_t> filterItems;
+    for (const auto& f : filters)
+        filterItems.push_back({ f.first, f.second });
+    nfdchar_t *outPath = NULL;
+    nfdresult_t result = NFD_OpenDialog(&outPath, filterItems.data(), (nfdfiltersize_t)filterItems.size(), nullptr);
+    if (result != NFD_OKAY)
+        return false;
+    path = outPath;
+    NFD_FreePath(outPath);
+    return true;
+}
+
 const std::string UNTITLED = "Untitled";
 const std::string DEFAULT_STYLE = "Dark";
 const std::string DEFAULT_UNIT = "dp";
@@ -72,6 +109,14 @@ struct File
     CppGen codeGen;
     bool modified = false;
     fs::file_time_type time[2];
+    CppGen::ImportDigest digest;
+    bool reloadPending = false; //reported by fileWatcher
+
+    //nodes of this document are allocated here, released when the file is closed
+    struct ArenaRelease {
+        void operator() (NodeArena* arena) { arena->Release(); }
+    };
+    std::unique_ptr<NodeArena, ArenaRelease> arena{ NodeArena::Create() };
 
     struct Config {
         std::string name;
@@ -82,6 +127,14 @@ struct File
     std::vector<Config> configs;
     int activeConfig = -1;
 
+    //per document designer state so switching tabs doesn't rebuild anything
+    //heap allocated because widgets and dialogs keep pointers into it
+    std::unique_ptr<UIContext> ctx = std::make_unique<UIContext>();
+    std::string styleKey; //style and unit ctx->style was loaded for
+    int styleGeneration = -1;
+    ImGuiStyle designStyle; //ctx->style scaled by designStyleZoom
+    float designStyleZoom = 0; //0 forces recalculation
+
     //msvc requires this
     File() = default;
     File(File&& f) noexcept = default;
@@ -103,7 +156,24 @@ std::string designFontName = "Roboto-Regular.ttf";
 float pgFontSize = 16;
 float designFontSize = 15;
 float zoomFactor = 1.f;
-UIContext ctx;
+UIContext appCtx; //app wide fields, used when no file is open
+UIContext* ctx = &appCtx; //context of the active tab
+//designer styles loaded so far keyed by style name, shared by all tabs and units
+//cleared when fonts are rebuilt
+struct DesignStyle
+{
+    ImGuiStyle style; //unit scaling is applied by LoadStyle
+    std::array<ImU32, UIContext::Color::COUNT> colors;
+    std::vector<std::string> fontNames;
+    ImFont* defaultStyleFont = nullptr;
+    std::vector<ImFont*> fonts; //added to the atlas for this style
+};
+std::map<std::string, DesignStyle> styleCache;
+int styleGeneration = 0;
+std::vector<std::string> staleStyles; //dropped from styleCache by LoadStyle
+ImGuiStyle appStyle; //ImRAD UI style set by ReloadStyles, restored after designer draws
+std::string uiFontsKey; //ImRAD UI fonts currently in the atlas
+int uiFontCount = 0; //designer fonts follow
 std::unique_ptr<Widget> newNode;
 std::vector<File> fileTabs;
 int activeTab = -1;
@@ -114,7 +184,6 @@ std::string lastPropName;
 std::string activeButton = "";
 std::vector<std::unique_ptr<Widget>> clipboard;
 float pgHeight = 0, pgeHeight = 0;
-std::thread stylesWatcher;
 
 struct TB_Button
 {
@@ -171,11 +240,33 @@ void DoReloadFile()
     if (file.fname == "" || !fs::is_regular_file(u8path(file.fname)))
         return;
 
+    //configurations whose Draw code didn't change keep their nodes and selection
+    //unsaved designer changes are discarded by reimporting everything
+    ctx->drawCache.Invalidate();
+    auto digest = file.codeGen.ReadImportDigest(file.fname);
+    std::set<std::string> skipDrawFuns;
+    if (!file.modified && digest.header == file.digest.header)
+    {
+        for (const auto& fun : digest.drawFuns) {
+            auto it = file.digest.drawFuns.find(fun.first);
+            if (it != file.digest.drawFuns.end() && it->second == fun.second)
+                skipDrawFuns.insert(fun.first);
+        }
+    }
+
     std::string activeConfig = file.configs[file.activeConfig].name;
+    UINode* activeRoot = file.configs[file.activeConfig].rootNode.get();
+    std::vector<File::Config> oldConfigs = std::move(file.configs);
     file.configs.clear();
     std::string error;
-    auto data = file.codeGen.Import(file.fname, error);
+    std::vector<CppGen::Config> data;
+    {
+        NodeArena::Scope arenaScope(file.arena.get());
+        data = file.codeGen.Import(file.fname, error, skipDrawFuns);
+    }
+    UINode::MarkEdited();
     if (data.empty()) {
+        file.configs = std::move(oldConfigs);
         errorBox.title = "CodeGen";
         errorBox.message = "Unsuccessful import because of errors";
         errorBox.error = error;
@@ -187,9 +278,16 @@ void DoReloadFile()
     for (auto& c : data)
     {
         File::Config& cfg = file.configs.emplace_back();
+        cfg.name = c.name;
         if (cfg.name == activeConfig)
             file.activeConfig = (int)file.configs.size() - 1;
-        cfg.name = c.name;
+        auto oit = stx::find_if(oldConfigs, [&](const File::Config& o) {
+            return o.name == c.name && o.rootNode;
+            });
+        if (!c.node && oit != oldConfigs.end()) {
+            cfg = std::move(*oit);
+            continue;
+        }
         cfg.rootNode.reset(c.node);
         auto it = c.params.find("style");
         cfg.styleName = it != c.params.end() ? it->second : DEFAULT_STYLE;
@@ -203,10 +301,20 @@ void DoReloadFile()
         it = c.params.find("unit");
         cfg.unit = it != c.params.end() ? it->second : "px";
     }
+    if (stx::count_if(file.configs, [](const File::Config& cfg) { return !cfg.rootNode; }))
+    {
+        //skipped Draw function without a matching configuration, do a full import
+        file.digest = {};
+        file.modified = true;
+        DoReloadFile();
+        return;
+    }
 
     file.modified = false;
-    ctx.selected = { file.configs[file.activeConfig].rootNode.get() };
-    ctx.mode = UIContext::NormalSelection;
+    file.digest = std::move(digest);
+    if (file.configs[file.activeConfig].rootNode.get() != activeRoot)
+        ctx->selected = { file.configs[file.activeConfig].rootNode.get() };
+    ctx->mode = UIContext::NormalSelection;
 
     if (error != "" && programState != Shutdown)
     {
@@ -222,6 +330,7 @@ void ReloadFile()
     if (activeTab < 0)
         return;
     auto& tab = fileTabs[activeTab];
+    tab.reloadPending = false;
     if (tab.fname == "" || !fs::is_regular_file(u8path(tab.fname)))
         return;
     auto time1 = fs::last_write_time(u8path(tab.fname));
@@ -232,6 +341,11 @@ void ReloadFile()
     tab.time[0] = time1;
     tab.time[1] = time2;
 
+    //user code edits (event handlers etc.) don't affect the design
+    //they are merged on the next save so no reload is needed
+    if (tab.codeGen.ReadImportDigest(tab.fname) == tab.digest)
+        return;
+
     if (programState != Shutdown)
     {
         std::string fn = u8string(u8path(tab.fname).filename());
@@ -250,6 +364,19 @@ void ReloadFile()
     }
 }
 
+//copies app wide fields into a document context
+void ShareAppContext(UIContext& dctx)
+{
+    if (&dctx == &appCtx)
+        return;
+    dctx.pgFont = appCtx.pgFont;
+    dctx.pgbFont = appCtx.pgbFont;
+    dctx.dashTexId = appCtx.dashTexId;
+    dctx.showUntranslated = appCtx.showUntranslated;
+    dctx.designAreaMin = appCtx.designAreaMin;
+    dctx.designAreaMax = appCtx.designAreaMax;
+}
+
 void ActivateTab(int i)
 {
     /*doesn't work when activeTab is closed
@@ -260,31 +387,39 @@ void ActivateTab(int i)
         i = (int)fileTabs.size() - 1;
     if (i < 0) {
         activeTab = -1;
-        ctx.selected.clear();
-        ctx.codeGen = nullptr;
+        ctx = &appCtx;
+        NodeArena::SetCurrent(nullptr);
+        ctx->selected.clear();
+        ctx->codeGen = nullptr;
         return;
     }
     activeTab = i;
     auto& tab = fileTabs[i];
     auto& cfg = tab.configs[tab.activeConfig];
-    ctx.selected = { cfg.rootNode.get() };
-    ctx.codeGen = &tab.codeGen;
-    ReloadFile();
-    //if (cfg.styleName != styleName)
-    reloadStyle = true;
+    //selection and caches of the tab are kept, style is reloaded by LoadStyle only when it changed
+    ShareAppContext(*tab.ctx);
+    ctx = tab.ctx.get();
+    NodeArena::SetCurrent(tab.arena.get());
+    if (ctx->selected.empty())
+        ctx->selected = { cfg.rootNode.get() };
+    ctx->codeGen = &tab.codeGen; //File was moved
+    if (!fileWatcher.Active() || tab.reloadPending)
+        ReloadFile();
 }
 
 void DoNewFile(TopWindow::Kind k)
 {
-    ctx.kind = k;
-    auto top = std::make_unique<TopWindow>(ctx);
     File file;
     file.modified = true;
+    file.ctx->kind = k;
     auto& cfg = file.configs.emplace_back();
     cfg.name = "";
     cfg.styleName = DEFAULT_STYLE;
     cfg.unit = k == TopWindow::Activity ? "dp" : DEFAULT_UNIT;
-    cfg.rootNode = std::move(top);
+    {
+        NodeArena::Scope arenaScope(file.arena.get());
+        cfg.rootNode = std::make_unique<TopWindow>(*file.ctx);
+    }
     file.activeConfig = 0;
     fileTabs.push_back(std::move(file));
     ActivateTab((int)fileTabs.size() - 1);
@@ -423,7 +558,12 @@ bool DoOpenFile(const std::string& path, std::string* errs = nullptr)
     file.time[1] = fs::last_write_time(u8path(file.codeGen.AltFName(file.fname)), err);
 
     std::string error;
-    auto data = file.codeGen.Import(file.fname, error);
+    std::vector<CppGen::Config> data;
+    {
+        NodeArena::Scope arenaScope(file.arena.get());
+        data = file.codeGen.Import(file.fname, error);
+    }
+    UINode::MarkEdited();
     if (data.empty()) {
         if (errs)
             *errs += "Unsuccessful import of '" + path + "'\n";
@@ -456,6 +596,7 @@ bool DoOpenFile(const std::string& path, std::string* errs = nullptr)
         cfg.name = c.name;
         cfg.rootNode.reset(c.node);
     }
+    file.digest = file.codeGen.ReadImportDigest(file.fname);
 
     auto it = stx::find_if(fileTabs, [&](const File& f) { return f.fname == file.fname; });
     if (it == fileTabs.end()) {
@@ -487,8 +628,8 @@ void OpenFile()
     if (result != NFD_OKAY)
         return;
 
-    ctx.mode = UIContext::NormalSelection;
-    ctx.selected.clear();
+    ctx->mode = UIContext::NormalSelection;
+    ctx->selected.clear();
     auto it = stx::find_if(fileTabs, [&](const File& f) { return f.fname == outPath; });
     if (it != fileTabs.end())
     {
@@ -527,8 +668,8 @@ void DoCloseFile(int flags)
     if (activeTab < 0)
         return;
 
-    ctx.root = nullptr;
-    ctx.selected.clear();
+    //closed tab owns the current context
+    ctx = &appCtx;
     fileTabs.erase(fileTabs.begin() + activeTab);
 
     if ((flags & CLOSE_ALL_BUT_PREVIOUS) && fileTabs.size() >= 2) {
@@ -609,6 +750,7 @@ void DoSaveFile(int flags)
     tab.modified = false;
     tab.time[0] = fs::last_write_time(u8path(tab.fname), err);
     tab.time[1] = fs::last_write_time(u8path(tab.codeGen.AltFName(tab.fname)), err);
+    tab.digest = tab.codeGen.ReadImportDigest(tab.fname);
     if (error != "" && programState != Shutdown)
     {
         errorBox.title = "CodeGen";
@@ -722,14 +864,14 @@ void ShowCode()
     std::ofstream fout(path);
     fout << "// NOTE: This is just a preview of the Draw() method. To see the complete code\n"
          << "// including class definition and event handlers inspect generated .h/cpp files\n\n";
-    ctx.ind = "";
+    ctx->ind = "";
     const auto& file = fileTabs[activeTab];
     auto* root = file.configs[file.activeConfig].rootNode.get();
-    root->Export(fout, ctx);
+    root->Export(fout, *ctx);
 
-    if (ctx.errors.size()) {
+    if (ctx->errors.size()) {
         fout << "\n// Export finished with errors:\n";
-        for (const std::string& e : ctx.errors)
+        for (const std::string& e : ctx->errors)
             fout << "// " << e <<  "\n";
     }
     fout.close();
@@ -741,44 +883,48 @@ void NewWidget(const std::string& name)
     if (name == "")
     {
         activeButton = "";
-        ctx.selected.clear();
-        ctx.mode = UIContext::NormalSelection;
+        ctx->selected.clear();
+        ctx->mode = UIContext::NormalSelection;
     }
     else if (name == "MenuBar")
     {
-        if (ctx.root->children.empty() ||
-            !dynamic_cast<MenuBar*>(ctx.root->children[0].get()))
+        if (ctx->root->children.empty() ||
+            !dynamic_cast<MenuBar*>(ctx->root->children[0].get()))
         {
-            dynamic_cast<TopWindow*>(ctx.root)->flags |= ImGuiWindowFlags_MenuBar;
-            ctx.root->children.insert(ctx.root->children.begin(), std::make_unique<MenuBar>(ctx));
-            ctx.selected = { ctx.root->children[0]->children[0].get() };
+            dynamic_cast<TopWindow*>(ctx->root)->flags |= ImGuiWindowFlags_MenuBar;
+            ctx->root->children.insert(ctx->root->children.begin(), std::make_unique<MenuBar>(*ctx));
+            ctx->selected = { ctx->root->children[0]->children[0].get() };
+            fileTabs[activeTab].modified = true;
+            UINode::MarkEdited();
         }
-        ctx.mode = UIContext::NormalSelection;
+        ctx->mode = UIContext::NormalSelection;
     }
     else if (name == "ContextMenu")
     {
         activeButton = "";
-        auto popup = std::make_unique<ContextMenu>(ctx);
-        auto item = std::make_unique<MenuIt>(ctx);
+        auto popup = std::make_unique<ContextMenu>(*ctx);
+        auto item = std::make_unique<MenuIt>(*ctx);
         item->label = "Item";
         popup->children.push_back(std::move(item));
         size_t i = 0;
-        for (; i < ctx.root->children.size(); ++i)
+        for (; i < ctx->root->children.size(); ++i)
         {
-            if (ctx.root->children[i]->Behavior() & Widget::SnapSides)
+            if (ctx->root->children[i]->Behavior() & Widget::SnapSides)
                 break;
         }
         popup->label = "ContextMenu" + std::to_string(i + 1);
-        ctx.root->children.insert(ctx.root->children.begin() + i, std::move(popup));
-        ctx.mode = UIContext::NormalSelection;
-        ctx.selected = { ctx.root->children[i]->children[0].get() };
+        ctx->root->children.insert(ctx->root->children.begin() + i, std::move(popup));
+        ctx->mode = UIContext::NormalSelection;
+        ctx->selected = { ctx->root->children[i]->children[0].get() };
+        fileTabs[activeTab].modified = true;
+        UINode::MarkEdited();
     }
     else
     {
         activeButton = name;
-        ctx.selected.clear();
-        ctx.mode = UIContext::SnapInsert;
-        newNode = Widget::Create(name, ctx);
+        ctx->selected.clear();
+        ctx->mode = UIContext::SnapInsert;
+        newNode = Widget::Create(name, *ctx);
     }
 }
 
@@ -890,57 +1036,102 @@ void GetStyles()
 
 void InitStylesWatcher()
 {
-#ifdef WIN32
-    stylesWatcher = std::thread([] {
-        HANDLE hDir = CreateFileW(
-            u8path(rootPath + "/style").wstring().c_str(),
-            FILE_LIST_DIRECTORY,
-            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-            NULL,
-            OPEN_EXISTING,
-            FILE_FLAG_BACKUP_SEMANTICS,
-            NULL
-        );
-        if (hDir == INVALID_HANDLE_VALUE)
-            return;
-        DWORD bytesReturned;
-        std::vector<std::byte> buffer(1024);
-        while (programState != Shutdown) {
-            if (ReadDirectoryChangesW(
-                hDir,
-                buffer.data(),
-                (DWORD)buffer.size(),
-                false,
-                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE,
-                &bytesReturned,
-                NULL,
-                NULL
-            )) {
-                reloadStyle = true;
-            }
+    //changes are delivered by ProcessFileChanges
+    fileWatcher.Watch(rootPath + "/style");
+}
+
+//keeps fileWatcher in sync with open files and explorer folder
+void WatchFiles()
+{
+    static std::vector<std::string> watched;
+    //hashing the names is cheaper than building the path list every frame
+    static ImU32 watchedKey = 0;
+    ImU32 key = ImHashStr(explorerPath.c_str());
+    for (const auto& tab : fileTabs)
+        key = ImHashStr(tab.fname.c_str(), 0, key);
+    if (key == watchedKey && watched.size())
+        return;
+    watchedKey = key;
+
+    std::vector<std::string> paths;
+    for (const auto& tab : fileTabs) {
+        if (tab.fname == "")
+            continue;
+        paths.push_back(tab.fname);
+        paths.push_back(tab.codeGen.AltFName(tab.fname));
+    }
+    paths.push_back(explorerPath);
+    if (paths == watched)
+        return;
+    //watch first so refcounts of unchanged paths don't drop to zero
+    for (const auto& path : paths)
+        fileWatcher.Watch(path);
+    for (const auto& path : watched)
+        fileWatcher.Unwatch(path);
+    watched = std::move(paths);
+}
+
+//only the active configuration's style is loaded, others load on activation
+void StyleChanged(const std::string& path)
+{
+    fs::path p = u8path(path);
+    if (p.extension() == ".stylebin")
+        return;
+    if (p.extension() != ".ini") {
+        std::string fname = u8string(p.filename());
+        if (fname == uiFontName || fname == pgFontName || fname == pgbFontName ||
+            fname == FONT_ICON_FILE_NAME_FAR || fname == FONT_ICON_FILE_NAME_FAS)
+            reloadStyle = true;
+        else {
+            //fonts, images used by designer styles
+            for (const auto& st : styleCache)
+                staleStyles.push_back(st.first);
         }
-        });
-    stylesWatcher.detach();
-#elif defined(__APPLE__)
-    //todo
-#else
-    stylesWatcher = std::thread([]{
-        int fd = inotify_init();
-        if (fd < 0)
-            return;
-        int wd = inotify_add_watch(fd, u8path(rootPath + "/style").string().c_str(), IN_MODIFY);
-        std::vector<std::byte> buffer(1024 * (sizeof(struct inotify_event) + 16));
-        while (programState != Shutdown) {
-            int len = read(fd, buffer.data(), buffer.size());
-            if (len < 0)
-                break;
+        return;
+    }
+    std::string name = u8string(p.stem());
+    bool known = stx::count_if(styleNames, [&](const auto& st) { return st.first == name; });
+    std::error_code err;
+    if (known != fs::exists(p, err))
+        GetStyles();
+    //only styles already loaded by some tab need a reload
+    if (styleCache.count(name))
+        staleStyles.push_back(name);
+}
+
+void ProcessFileChanges()
+{
+    if (!fileWatcher.Active())
+        return;
+    WatchFiles();
+
+    std::string path;
+    std::string styleDir = FileWatcher::NormalPath(rootPath + "/style");
+    std::string explorerDir = FileWatcher::NormalPath(explorerPath);
+    while (fileWatcher.PopChange(path))
+    {
+        //empty path means events were lost, recheck everything
+        std::string dir = u8string(u8path(path).parent_path());
+        if (path == "")
             reloadStyle = true;
+        else if (dir == styleDir)
+            StyleChanged(path);
+        if (path == "" || dir == explorerDir)
+            RefreshExplorer();
+        for (auto& tab : fileTabs) {
+            if (tab.fname == "")
+                continue;
+            if (path == "" ||
+                path == FileWatcher::NormalPath(tab.fname) ||
+                path == FileWatcher::NormalPath(tab.codeGen.AltFName(tab.fname)))
+                tab.reloadPending = true;
         }
-        inotify_rm_watch(fd, wd);
-        close(fd);
-    });
-    stylesWatcher.detach();
-#endif
+    }
+    //inactive tabs are checked in ActivateTab
+    //ReloadFile filters out our own saves by comparing mtimes
+    if (activeTab >= 0 && fileTabs[activeTab].reloadPending &&
+        programState == Run && !ImGui::GetTopMostAndVisiblePopupModal())
+        ReloadFile();
 }
 
 const std::array<ImU32, UIContext::Color::COUNT>&
@@ -982,11 +1173,9 @@ GetCtxColors(const std::string& styleName)
         return classic;
 }
 
-void LoadStyle()
+//reloads ImRAD UI style and fonts
+void ReloadStyles()
 {
-    if (!reloadStyle)
-        return;
-
     ImGui::SetMouseCursor(ImGuiMouseCursor_Wait);
     reloadStyle = false;
     auto& io = ImGui::GetIO();
@@ -1026,115 +1215,195 @@ void LoadStyle()
     ImRad::GetUserData().dpiScale = dpiScale;
     ImGui::GetStyle().FontScaleDpi = dpiScale;
 
-    io.Fonts->Clear();
     ImGui::GetStyle().FontSizeBase = uiFontSize;
-    io.Fonts->AddFontFromFileTTF((stylePath + uiFontName).c_str(), uiFontSize);
-    ImFontConfig cfg;
-    cfg.MergeMode = true;
-    //icons_config.PixelSnapH = true;
-    const float faSize = uiFontSize * 18.f / 20.f;
-    io.Fonts->AddFontFromFileTTF((stylePath + FONT_ICON_FILE_NAME_FAR).c_str(), faSize, &cfg);
-    io.Fonts->AddFontFromFileTTF((stylePath + FONT_ICON_FILE_NAME_FAS).c_str(), faSize, &cfg);
-    cfg.MergeMode = false;
-
-    strcpy(cfg.Name, "imrad.pg");
-    ctx.pgFont = io.Fonts->AddFontFromFileTTF((stylePath + pgFontName).c_str(), pgFontSize, &cfg);
-    cfg.MergeMode = true;
-    io.Fonts->AddFontFromFileTTF((stylePath + FONT_ICON_FILE_NAME_FAR).c_str(), pgFontSize * 16.f / 20, &cfg);
-    io.Fonts->AddFontFromFileTTF((stylePath + FONT_ICON_FILE_NAME_FAS).c_str(), pgFontSize * 16.f / 20, &cfg);
-    cfg.MergeMode = false;
-    strcpy(cfg.Name, "imrad.pgb");
-    ctx.pgbFont = io.Fonts->AddFontFromFileTTF((stylePath + pgbFontName).c_str(), pgFontSize, &cfg);
-    strcpy(cfg.Name, "imrad.explorer");
-    io.Fonts->AddFontFromFileTTF((stylePath + "Roboto-Regular.ttf").c_str(), uiFontSize, &cfg);
-    cfg.MergeMode = true;
-    io.Fonts->AddFontFromFileTTF((stylePath + FONT_ICON_FILE_NAME_FAS).c_str(), faSize, &cfg);
-    cfg.MergeMode = false;
-
-    //set active designer style
-    ctx.defaultStyleFont = nullptr;
-    ctx.fontNames.clear();
-    stx::fill(ctx.colors, IM_COL32(0, 0, 0, 255));
-    ctx.style = {};
-    ctx.unit = DEFAULT_UNIT;
-
-    if (activeTab >= 0)
+    //only ReloadStyles changes ImRAD UI style so Draw doesn't need to save it every frame
+    appStyle = ImGui::GetStyle();
+    //ImRAD UI fonts are kept across style switches, only designer fonts get rebuilt
+    std::string fontsKey = stylePath + uiFontName + "|" + pgFontName + "|" + pgbFontName + "|" +
+        std::to_string(uiFontSize) + "|" + std::to_string(pgFontSize);
+    if (fontsKey != uiFontsKey || io.Fonts->Fonts.Size < uiFontCount)
     {
-        auto& file = fileTabs[activeTab];
-        auto& cfg = file.configs[file.activeConfig];
-        ctx.unit = cfg.unit;
+        uiFontsKey = fontsKey;
+        io.Fonts->Clear();
+        ImRad::AddFontFromFileCached(stylePath + uiFontName, uiFontSize);
+        ImFontConfig cfg;
+        cfg.MergeMode = true;
+        //icons_config.PixelSnapH = true;
+        const float faSize = uiFontSize * 18.f / 20.f;
+        ImRad::AddFontFromFileCached(stylePath + FONT_ICON_FILE_NAME_FAR, faSize, &cfg);
+        ImRad::AddFontFromFileCached(stylePath + FONT_ICON_FILE_NAME_FAS, faSize, &cfg);
+        cfg.MergeMode = false;
+
+        strcpy(cfg.Name, "imrad.pg");
+        appCtx.pgFont = ImRad::AddFontFromFileCached(stylePath + pgFontName, pgFontSize, &cfg);
+        cfg.MergeMode = true;
+        ImRad::AddFontFromFileCached(stylePath + FONT_ICON_FILE_NAME_FAR, pgFontSize * 16.f / 20, &cfg);
+        ImRad::AddFontFromFileCached(stylePath + FONT_ICON_FILE_NAME_FAS, pgFontSize * 16.f / 20, &cfg);
+        cfg.MergeMode = false;
+        strcpy(cfg.Name, "imrad.pgb");
+        appCtx.pgbFont = ImRad::AddFontFromFileCached(stylePath + pgbFontName, pgFontSize, &cfg);
+        strcpy(cfg.Name, "imrad.explorer");
+        ImRad::AddFontFromFileCached(stylePath + "Roboto-Regular.ttf", uiFontSize, &cfg);
+        cfg.MergeMode = true;
+        ImRad::AddFontFromFileCached(stylePath + FONT_ICON_FILE_NAME_FAS, faSize, &cfg);
+        cfg.MergeMode = false;
+        uiFontCount = io.Fonts->Fonts.Size;
+    }
+    else
+    {
+        while (io.Fonts->Fonts.Size > uiFontCount)
+            io.Fonts->RemoveFont(io.Fonts->Fonts.back());
+    }
 
-        if (cfg.styleName == "Classic")
-        {
-            ImGui::StyleColorsClassic(&ctx.style);
-            ctx.defaultStyleFont = io.Fonts->AddFontFromFileTTF((stylePath + designFontName).c_str(), designFontSize);
-            ctx.defaultStyleFont->FallbackChar = '#';
-            ctx.fontNames = { "" };
-            ctx.colors = GetCtxColors(cfg.styleName);
-        }
-        else if (cfg.styleName == "Light")
-        {
-            ImGui::StyleColorsLight(&ctx.style);
-            ctx.defaultStyleFont = io.Fonts->AddFontFromFileTTF((stylePath + designFontName).c_str(), designFontSize);
-            ctx.defaultStyleFont->FallbackChar = '#';
-            ctx.fontNames = { "" };
-            ctx.colors = GetCtxColors(cfg.styleName);
-        }
-        else if (cfg.styleName == "Dark")
-        {
-            ImGui::StyleColorsDark(&ctx.style);
-            ctx.defaultStyleFont = io.Fonts->AddFontFromFileTTF((stylePath + designFontName).c_str(), designFontSize);
-            ctx.defaultStyleFont->FallbackChar = '#';
-            ctx.fontNames = { "" };
-            ctx.colors = GetCtxColors(cfg.styleName);
-        }
-        else
-        {
-            std::map<std::string, ImFont*> fontMap;
-            std::map<std::string, std::string> extra;
+    //designer fonts are dropped with the atlas so all loaded styles are invalid
+    styleCache.clear();
+    staleStyles.clear();
+    ++styleGeneration;
+    ShareAppContext(*ctx);
+}
+
+DesignStyle LoadDesignStyle(const std::string& styleName)
+{
+    std::string stylePath = rootPath + "/style/";
+    float dpiScale = ImGui_ImplGlfw_GetContentScaleForMonitor(glfwGetPrimaryMonitor());
+    DesignStyle ds;
+    stx::fill(ds.colors, IM_COL32(0, 0, 0, 255));
+
+    if (styleName == "Classic")
+    {
+        ImGui::StyleColorsClassic(&ds.style);
+        ds.defaultStyleFont = ImRad::AddFontFromFileCached(stylePath + designFontName, designFontSize);
+        ds.defaultStyleFont->FallbackChar = '#';
+        ds.fontNames = { "" };
+        ds.colors = GetCtxColors(styleName);
+    }
+    else if (styleName == "Light")
+    {
+        ImGui::StyleColorsLight(&ds.style);
+        ds.defaultStyleFont = ImRad::AddFontFromFileCached(stylePath + designFontName, designFontSize);
+        ds.defaultStyleFont->FallbackChar = '#';
+        ds.fontNames = { "" };
+        ds.colors = GetCtxColors(styleName);
+    }
+    else if (styleName == "Dark")
+    {
+        ImGui::StyleColorsDark(&ds.style);
+        ds.defaultStyleFont = ImRad::AddFontFromFileCached(stylePath + designFontName, designFontSize);
+        ds.defaultStyleFont->FallbackChar = '#';
+        ds.fontNames = { "" };
+        ds.colors = GetCtxColors(styleName);
+    }
+    else
+    {
+        std::map<std::string, ImFont*> fontMap;
+        std::map<std::string, std::string> extra;
+        try {
+            auto it = stx::find_if(styleNames, [&](const auto& s) { return s.first == styleName; });
+            ImRad::LoadStyle(it->second, 1.f, &ds.style, &fontMap, &extra);
+            //keep compiled style for generated apps in sync
             try {
-                auto it = stx::find_if(styleNames, [&](const auto& s) { return s.first == cfg.styleName; });
-                ImRad::LoadStyle(it->second, 1.f, &ctx.style, &fontMap, &extra);
-                ctx.style.FontScaleDpi = dpiScale;
+                if (!ImRad::IsStyleCompiled(it->second))
+                    ImRad::CompileStyle(it->second);
+            }
+            catch (std::exception&) {
+            }
+            ds.style.FontScaleDpi = dpiScale;
 
-                ctx.defaultStyleFont = fontMap[""];
-                for (const auto& f : fontMap) {
-                    ctx.fontNames.push_back(f.first);
-                }
-                for (const auto& ex : extra) {
-                    if (ex.first.compare(0, 13, "imrad.colors."))
-                        continue;
-                    std::istringstream is(ex.second);
-                    int r, g, b, a;
-                    is >> r >> g >> b >> a;
-                    auto clr = IM_COL32(r, g, b, a);
-                    std::string key = ex.first.substr(13);
-
-#define SET_CLR(a) if (key == #a) ctx.colors[UIContext::a] = clr;
-                    SET_CLR(Selected);
-                    SET_CLR(Hovered);
-                    SET_CLR(DrawArgs);
-                    SET_CLR(Snap1);
-                    SET_CLR(Snap2);
-                    SET_CLR(Snap3);
-                    SET_CLR(Snap4);
-                    SET_CLR(Snap5);
-#undef SET_CLR
-                }
+            ds.defaultStyleFont = fontMap[""];
+            for (const auto& f : fontMap) {
+                ds.fontNames.push_back(f.first);
+                if (f.second && !stx::count(ds.fonts, f.second))
+                    ds.fonts.push_back(f.second);
             }
-            catch (std::exception& e)
-            {
-                //can't OpenPopup here, there is no glfwWindow parent
-                showError = e.what();
+            for (const auto& ex : extra) {
+                if (ex.first.compare(0, 13, "imrad.colors."))
+                    continue;
+                std::istringstream is(ex.second);
+                int r, g, b, a;
+                is >> r >> g >> b >> a;
+                auto clr = IM_COL32(r, g, b, a);
+                std::string key = ex.first.substr(13);
+
+#define SET_CLR(a) if (key == #a) ds.colors[UIContext::a] = clr;
+                SET_CLR(Selected);
+                SET_CLR(Hovered);
+                SET_CLR(DrawArgs);
+                SET_CLR(Snap1);
+                SET_CLR(Snap2);
+                SET_CLR(Snap3);
+                SET_CLR(Snap4);
+                SET_CLR(Snap5);
+#undef SET_CLR
             }
         }
-
-        if (ctx.unit == "dp") {
-            ctx.style.FontScaleDpi = dpiScale;
-            //ctx.style.FontSizeBase = designFontSize;
-            ctx.style.ScaleAllSizes(dpiScale);
+        catch (std::exception& e)
+        {
+            //can't OpenPopup here, there is no glfwWindow parent
+            showError = e.what();
         }
     }
+    if (ds.fonts.empty() && ds.defaultStyleFont)
+        ds.fonts.push_back(ds.defaultStyleFont);
+    return ds;
+}
+
+//tabs keep their designer style until the style or font atlas changes
+bool IsDesignStyleLoaded(const File& file)
+{
+    const auto& cfg = file.configs[file.activeConfig];
+    return file.styleGeneration == styleGeneration &&
+        file.styleKey == cfg.styleName + "|" + cfg.unit;
+}
+
+//drops changed styles and their fonts, tabs using them reload on activation
+void DropStaleStyles()
+{
+    for (const auto& name : staleStyles)
+    {
+        auto it = styleCache.find(name);
+        if (it == styleCache.end())
+            continue;
+        for (ImFont* font : it->second.fonts)
+            ImGui::GetIO().Fonts->RemoveFont(font);
+        styleCache.erase(it);
+        for (auto& tab : fileTabs)
+            if (!tab.styleKey.compare(0, name.size() + 1, name + "|"))
+                tab.styleGeneration = -1;
+    }
+    staleStyles.clear();
+}
+
+//must be called before NewFrame because it can add fonts
+void LoadStyle()
+{
+    if (reloadStyle)
+        ReloadStyles();
+    DropStaleStyles();
+
+    if (activeTab < 0 || IsDesignStyleLoaded(fileTabs[activeTab]))
+        return;
+    auto& file = fileTabs[activeTab];
+    const auto& cfg = file.configs[file.activeConfig];
+    //fonts are loaded once per style, unit only scales sizes
+    auto it = styleCache.find(cfg.styleName);
+    if (it == styleCache.end()) {
+        ImGui::SetMouseCursor(ImGuiMouseCursor_Wait);
+        it = styleCache.emplace(cfg.styleName, LoadDesignStyle(cfg.styleName)).first;
+    }
+    file.styleKey = cfg.styleName + "|" + cfg.unit;
+    file.styleGeneration = styleGeneration;
+    file.designStyleZoom = 0;
+    file.ctx->style = it->second.style;
+    if (cfg.unit == "dp") {
+        float dpiScale = ImGui_ImplGlfw_GetContentScaleForMonitor(glfwGetPrimaryMonitor());
+        file.ctx->style.FontScaleDpi = dpiScale;
+        file.ctx->style.ScaleAllSizes(dpiScale);
+    }
+    file.ctx->colors = it->second.colors;
+    file.ctx->fontNames = it->second.fontNames;
+    file.ctx->defaultStyleFont = it->second.defaultStyleFont;
+    file.ctx->unit = cfg.unit;
+    file.ctx->drawCache.Invalidate();
 }
 
 bool CopyStyle(const std::string& from, const std::string& name, std::string& err)
@@ -1179,6 +1448,7 @@ bool CopyStyle(const std::string& from, const std::string& name, std::string& er
         {
             fs::copy_file(u8path(rootPath + "/style/" + from + ".ini"), u8path(path), fs::copy_options::overwrite_existing);
         }
+        ImRad::CompileStyle(path);
         return true;
     }
     catch (std::exception& e)
@@ -1213,8 +1483,7 @@ void CloneStyle()
         if (st == styleNames.end())
             return;
         auto& file = fileTabs[activeTab];
-        file.configs[file.activeConfig].styleName = st->first;
-        reloadStyle = true;
+        file.configs[file.activeConfig].styleName = st->first; //loaded by LoadStyle
         ShellExec(st->second);
         });
 }
@@ -1267,7 +1536,7 @@ void EditConfigurations()
             File::Config* cfg;
             if (c.id < 0) { //new config
                 cfg = &file.configs.emplace_back();
-                cfg->rootNode = std::make_unique<TopWindow>(ctx);
+                cfg->rootNode = std::make_unique<TopWindow>(*ctx);
                 cfg->rootNode->kind = kind;
                 allIds.push_back((int)file.configs.size() - 1);
             }
@@ -1292,10 +1561,11 @@ void EditConfigurations()
             }) - file.configs.begin());
         if (file.activeConfig == file.configs.size()) {
             file.activeConfig = 0;
-            ctx.selected.clear();
+            ctx->selected.clear();
         }
         GetStyles();
-        reloadStyle = true;
+        //styles of changed configurations are loaded by LoadStyle
+        file.styleGeneration = -1;
     });
 }
 
@@ -1382,8 +1652,8 @@ void DockspaceUI()
 
     ImGui::DockSpace(dockspace_id, { 0.0f, 0.0f }, ImGuiDockNodeFlags_PassthruCentralNode | ImGuiDockNodeFlags_NoDockingOverCentralNode);
     ImGuiDockNode* cn = ImGui::DockBuilderGetCentralNode(dockspace_id);
-    ctx.designAreaMin = cn->Pos + ImVec2(0, tabSize);
-    ctx.designAreaMax = cn->Pos + cn->Size;
+    ctx->designAreaMin = appCtx.designAreaMin = cn->Pos + ImVec2(0, tabSize);
+    ctx->designAreaMax = appCtx.designAreaMax = cn->Pos + cn->Size;
 
     if (fileTabs.empty())
     {
@@ -1433,8 +1703,8 @@ void DockspaceUI()
     {
         float sp = ImGui::GetStyle().ItemSpacing.x;
         ImGui::SetCursorScreenPos({
-            ctx.designAreaMin.x + sp,
-            ctx.designAreaMax.y - ImGui::GetTextLineHeight() - sp
+            ctx->designAreaMin.x + sp,
+            ctx->designAreaMax.y - ImGui::GetTextLineHeight() - sp
             });
         ImVec4 clr = ImGui::GetStyleColorVec4(ImGuiCol_Text);
         clr.w = 0.5f;
@@ -1545,8 +1815,7 @@ void ToolbarUI()
             {
                 thisFile->activeConfig = (int)i;
                 //ftab->modified = true;
-                ctx.selected = { thisFile->configs[thisFile->activeConfig].rootNode.get() };
-                reloadStyle = true;
+                ctx->selected = { thisFile->configs[thisFile->activeConfig].rootNode.get() };
             }
         }
         ImGui::Separator();
@@ -1576,9 +1845,10 @@ void ToolbarUI()
     ImGui::SameLine();
     if (ImGui::Button(ICON_FA_CUBES))
     {
-        classWizard.codeGen = ctx.codeGen;
+        classWizard.codeGen = ctx->codeGen;
         classWizard.roots.clear();
         classWizard.modified = &thisFile->modified;
+        classWizard.varUsage = &ctx->varUsage;
         for (auto& cfg : thisFile->configs)
             classWizard.roots.push_back(cfg.rootNode.get());
         classWizard.OpenPopup();
@@ -1587,10 +1857,10 @@ void ToolbarUI()
 
     ImGui::SameLine();
     ImGui::PushStyleColor(ImGuiCol_Button,
-        ImGui::GetStyleColorVec4(ctx.showUntranslated ? ImGuiCol_ButtonActive : ImGuiCol_Button));
+        ImGui::GetStyleColorVec4(ctx->showUntranslated ? ImGuiCol_ButtonActive : ImGuiCol_Button));
     if (ImGui::Button(ICON_FA_GLOBE)) //TEXT_SLASH))
     {
-        ctx.showUntranslated = !ctx.showUntranslated;
+        ctx->showUntranslated = appCtx.showUntranslated = !ctx->showUntranslated;
     }
     ImGui::PopStyleColor();
     ImGui::SetItemTooltip("Show untranslated strings");
@@ -1600,11 +1870,11 @@ void ToolbarUI()
 
     ImGui::SameLine();
     bool showHelper = activeTab >= 0 &&
-        ctx.selected.size() >= 1 &&
-        (ctx.selected[0]->Behavior() & UINode::SnapSides);
+        ctx->selected.size() >= 1 &&
+        (ctx->selected[0]->Behavior() & UINode::SnapSides);
     if (showHelper)
     {
-        auto pinfo = ctx.root->FindChild(ctx.selected[0]);
+        auto pinfo = ctx->root->FindChild(ctx->selected[0]);
         if (!pinfo || (pinfo->first->Behavior() & UINode::SnapItemInterior))
             showHelper = false;
     }
@@ -1612,9 +1882,9 @@ void ToolbarUI()
     if (ImGui::Button(ICON_FA_BORDER_NONE))
     {
         horizLayout.root = thisFile->configs[thisFile->activeConfig].rootNode.get();
-        HorizLayout::ExpandSelection(ctx.selected, horizLayout.root);
-        horizLayout.selected = ctx.selected;
-        horizLayout.ctx = &ctx;
+        HorizLayout::ExpandSelection(ctx->selected, horizLayout.root);
+        horizLayout.selected = ctx->selected;
+        horizLayout.ctx = ctx;
         horizLayout.OpenPopup();
     }
     ImGui::EndDisabled();
@@ -1691,8 +1961,8 @@ void TabsUI()
     ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 0);
     ImGui::PushStyleVar(ImGuiStyleVar_WindowMinSize, { 0, 0 });
     ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, { 4, 0.0f });
-    ImGui::SetNextWindowPos({ ctx.designAreaMin.x, ctx.designAreaMin.y - tabSize });
-    ImGui::SetNextWindowSize({ ctx.designAreaMax.x - ctx.designAreaMin.x, tabSize });
+    ImGui::SetNextWindowPos({ ctx->designAreaMin.x, ctx->designAreaMin.y - tabSize });
+    ImGui::SetNextWindowSize({ ctx->designAreaMax.x - ctx->designAreaMin.x, tabSize });
     ImGui::Begin("FileTabs", 0, window_flags);
     ImGui::PopStyleVar(4);
     ImGui::PushItemFlag(ImGuiItemFlags_NoNav, true);
@@ -1772,14 +2042,39 @@ void TabsUI()
 
 void HierarchyUI()
 {
-    //ImGui::PushFont(ctx.defaultFont); icons are FA
+    //ImGui::PushFont(ctx->defaultFont); icons are FA
     ImGui::PushStyleVarX(ImGuiStyleVar_WindowPadding, 0);
     ImGui::Begin("Hierarchy");
+    //rows are rebuilt only when the model changed, selection is checked when drawing
+    static std::vector<UINode::TreeRow> rows;
+    static UINode* rowsRoot = nullptr;
+    static unsigned rowsInstanceGen = 0, rowsEditGen = 0;
+    static std::string rowsName;
+    UINode* root = nullptr;
     if (activeTab >= 0) {
         const auto& file = fileTabs[activeTab];
-        const auto& cfg = file.configs[file.activeConfig];
-        if (cfg.rootNode)
-            cfg.rootNode->TreeUI(ctx);
+        root = file.configs[file.activeConfig].rootNode.get();
+    }
+    if (root != rowsRoot ||
+        rowsInstanceGen != UINode::instanceGeneration ||
+        rowsEditGen != UINode::editGeneration ||
+        (root && rowsName != ctx->codeGen->GetName()))
+    {
+        rowsRoot = root;
+        rowsInstanceGen = UINode::instanceGeneration;
+        rowsEditGen = UINode::editGeneration;
+        rows.clear();
+        if (root) {
+            rowsName = ctx->codeGen->GetName();
+            root->TreeRows(rows, 0, *ctx);
+        }
+    }
+    ImGuiListClipper clipper;
+    clipper.Begin((int)rows.size());
+    while (clipper.Step())
+    {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            UINode::TreeRowUI(rows[i], *ctx);
     }
     ImGui::End();
     ImGui::PopStyleVar();
@@ -1787,7 +2082,7 @@ void HierarchyUI()
 
 void ExplorerUI()
 {
-    ExplorerUI(*ctx.codeGen, [](const std::string& fpath) {
+    ExplorerUI(*ctx->codeGen, [](const std::string& fpath) {
         DoOpenFile(fpath);
     });
 }
@@ -1801,7 +2096,7 @@ bool BeginPropGroup(const std::string& cat, bool forceOpen, bool& forceSameRow)
     ImGui::TableSetColumnIndex(0);
     ImGui::AlignTextToFramePadding();
     ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, { 0.0f, pad.y });
-    ImGui::PushFont(topLevel ? ctx.pgbFont : ctx.pgFont, pgFontSize);
+    ImGui::PushFont(topLevel ? ctx->pgbFont : ctx->pgFont, pgFontSize);
     int flags = ImGuiTreeNodeFlags_SpanAllColumns | ImGuiTreeNodeFlags_NoNavFocus;
     std::string str;
     if (topLevel)
@@ -1872,9 +2167,99 @@ std::vector<std::string_view> GetCat(std::string_view pname)
     return cat;
 }
 
+//property grid rows common to the selection set
+//rebuilt only when selection or property layout of selected nodes changes
+struct PropGridModel
+{
+    struct Row {
+        int index; //into Properties()/Events() of selected[0]
+        std::string name;
+        std::vector<std::string> cat;
+        property_base* property;
+        std::vector<property_base*> slots; //same property in other selected nodes
+    };
+    std::vector<std::pair<UINode*, const UINode::PropTable*>> key;
+    unsigned generation = 0; //UINode::editGeneration, names depend on node state
+    std::vector<Row> rows;
+    size_t count = 0; //all properties of selected[0]
+};
+
+const PropGridModel& GetPropGridModel(bool pr)
+{
+    static PropGridModel models[2];
+    auto& model = models[pr];
+    std::vector<std::pair<UINode*, const UINode::PropTable*>> key;
+    key.reserve(ctx->selected.size());
+    for (auto* node : ctx->selected)
+        key.push_back({ node, &node->GetPropTable() });
+    if (key == model.key && model.generation == UINode::editGeneration)
+        return model;
+
+    model.key = std::move(key);
+    model.generation = UINode::editGeneration;
+    model.rows.clear();
+    //determine common properties for a selection set
+    //todo: remember to clear out differing values
+    //todo: combine enabled state
+    std::vector<std::vector<UINode::Prop>> props;
+    for (auto* node : ctx->selected) {
+        auto& pn = props.emplace_back(pr ? node->Properties() : node->Events());
+        stx::sort(pn, [](const auto& a, const auto& b) { return a.name < b.name; });
+    }
+    auto props0 = pr ? ctx->selected[0]->Properties() : ctx->selected[0]->Events();
+    model.count = props0.size();
+    for (int i = 0; i < (int)props0.size(); ++i)
+    {
+        const auto& prop = props0[i];
+        if (ctx->selected.size() > 1 &&
+            prop.name.size() > 3 && !prop.name.compare(prop.name.size() - 3, 3, "##1"))
+            continue;
+        PropGridModel::Row row;
+        row.index = i;
+        row.property = prop.property;
+        bool common = true;
+        for (size_t j = 1; j < props.size() && common; ++j) {
+            auto it = std::lower_bound(props[j].begin(), props[j].end(), prop.name,
+                [](const auto& p, std::string_view name) { return p.name < name; });
+            common = it != props[j].end() && it->name == prop.name;
+            if (common && it->property)
+                row.slots.push_back(it->property);
+        }
+        if (!common)
+            continue;
+        row.name = prop.name;
+        for (const auto& c : GetCat(prop.name))
+            row.cat.push_back(std::string(c));
+        model.rows.push_back(std::move(row));
+    }
+    return model;
+}
+
+//ctx->parents is recomputed only when the cached chain doesn't lead to selected[0]
+void UpdateParents()
+{
+    if (ctx->selected.empty() || !ctx->root)
+        return;
+    bool valid = ctx->parents.size() && ctx->parents[0] == ctx->root &&
+        ctx->parents.back() == ctx->selected[0];
+    for (size_t i = 0; valid && i + 1 < ctx->parents.size(); ++i) {
+        valid = stx::count_if(ctx->parents[i]->children, [&](const auto& ch) {
+            return ch.get() == ctx->parents[i + 1];
+            });
+    }
+    if (valid)
+        return;
+    UINode* cur = ctx->selected[0];
+    ctx->parents = { cur };
+    while (auto pinfo = ctx->root->FindChild(cur)) {
+        cur = pinfo->first;
+        ctx->parents.insert(ctx->parents.begin(), cur);
+    }
+}
+
 void PropertyRowsUI(bool pr)
 {
-    if (ctx.selected.empty())
+    if (ctx->selected.empty())
         return;
 
     int keyPressed = 0;
@@ -1919,12 +2304,12 @@ void PropertyRowsUI(bool pr)
     if (pr)
     {
         std::string header;
-        if (ctx.selected.size() == 1) {
-            header = "[" + ctx.selected[0]->GetTypeName() + "]";
+        if (ctx->selected.size() == 1) {
+            header = "[" + ctx->selected[0]->GetTypeName() + "]";
         }
         else
-            header = std::to_string(ctx.selected.size()) + " selected";
-        ImGui::PushFont(ctx.pgbFont, pgFontSize);
+            header = std::to_string(ctx->selected.size()) + " selected";
+        ImGui::PushFont(ctx->pgbFont, pgFontSize);
         ImGui::PushStyleColor(ImGuiCol_ChildBg, sideColor);
         if (ImGui::BeginChild("##typeChld", { -1, 0 }, ImGuiChildFlags_AlwaysAutoResize | ImGuiChildFlags_AutoResizeY | ImGuiChildFlags_AlwaysUseWindowPadding, 0)) {
             ImGui::Indent(sideWidth + ImGui::GetStyle().CellPadding.x);
@@ -1948,7 +2333,7 @@ void PropertyRowsUI(bool pr)
         { pgMin.x + sideWidth + 1, ImGui::GetCurrentWindow()->InnerRect.Max.y },
         rowColor
     );
-    ImGui::PushFont(ctx.pgFont, pgFontSize);
+    ImGui::PushFont(ctx->pgFont, pgFontSize);
     ImGui::PushItemFlag(ImGuiItemFlags_NoNav, true); //ImGuiChildFlags_NavFlattened emulation
     ImGuiTableFlags flags = ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersInnerH | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
     if (ImGui::BeginTable(pr ? "pg" : "pge", 2, flags))
@@ -1958,43 +2343,14 @@ void PropertyRowsUI(bool pr)
         ImGui::PushItemFlag(ImGuiItemFlags_NoNav, false); //Pop+Push doesn't work here
 
         //find parents for widget::PropertyUI and BindingButton
-        if (ctx.selected.size() && ctx.root) {
-            UINode* cur = ctx.selected[0];
-            ctx.parents = { cur };
-            while (auto pinfo = ctx.root->FindChild(cur)) {
-                cur = pinfo->first;
-                ctx.parents.insert(ctx.parents.begin(), cur);
-            }
-        }
-        //determine common properties for a selection set
-        //todo: remember to clear out differing values
-        //todo: combine enabled state
-        std::vector<std::string_view> pnames;
-        for (auto* node : ctx.selected)
-        {
-            std::vector<std::string_view> pn;
-            auto props = pr ? node->Properties() : node->Events();
-            for (auto& p : props) {
-                if (ctx.selected.size() == 1 ||
-                    (p.name.size() > 3 && p.name.compare(p.name.size() - 3, 3, "##1")))
-                {
-                    pn.push_back(p.name);
-                }
-            }
-            stx::sort(pn);
-            if (node == ctx.selected[0])
-                pnames = std::move(pn);
-            else {
-                std::vector<std::string_view> pres;
-                stx::set_intersection(pnames, pn, std::back_inserter(pres));
-                pnames = std::move(pres);
-            }
-        }
+        UpdateParents();
+        const PropGridModel& model = GetPropGridModel(pr);
         std::vector<std::string_view> forceCatOpen;
         if (pr && keyPressed)
         {
-            if (stx::count(pnames, lastPropName))
-                forceCatOpen = GetCat(lastPropName);
+            auto it = stx::find_if(model.rows, [](const auto& row) { return row.name == lastPropName; });
+            if (it != model.rows.end())
+                forceCatOpen.assign(it->cat.begin(), it->cat.end());
         }
 
         //when selecting other widget of same kind from Tree, value from previous widget
@@ -2002,21 +2358,17 @@ void PropertyRowsUI(bool pr)
         //PushID widget ptr to prevent it
         //We PopID/PushID before a category treeNode to keep them open/close across all widgets
         //having same property
-        ImGui::PushID(ctx.selected[0]);
+        ImGui::PushID(ctx->selected[0]);
         //edit first widget
-        auto props = pr ? ctx.selected[0]->Properties() : ctx.selected[0]->Events();
-        bool copyChange = false;
+        const PropGridModel::Row* changedRow = nullptr;
         std::string pval;
         std::vector<std::string_view> lastCat;
         std::vector<bool> catOpen;
-        for (int i = 0; i < (int)props.size(); ++i)
+        for (const auto& row : model.rows)
         {
-            const auto& prop = props[i];
-            if (!stx::count(pnames, prop.name))
-                continue;
-            std::vector<std::string_view> cat = GetCat(prop.name);
+            const auto& cat = row.cat;
             bool forceSameRow = false;
-            if (cat != lastCat)
+            if (!std::equal(cat.begin(), cat.end(), lastCat.begin(), lastCat.end()))
             {
                 while (lastCat.size() &&
                     (lastCat.size() > cat.size() ||
@@ -2036,14 +2388,14 @@ void PropertyRowsUI(bool pr)
                     {
                         ImGui::PopID();
                         open = BeginPropGroup(stx::join(lastCat, "."), forceOpen, forceSameRow);
-                        ImGui::PushID(ctx.selected[0]);
+                        ImGui::PushID(ctx->selected[0]);
                     }
                     catOpen.push_back(open);
                 }
             }
             if (lastCat.size() && stx::count(catOpen, false) && !forceSameRow)
                 continue;
-            if (keyPressed && props[i].name == lastPropName) {
+            if (keyPressed && row.name == lastPropName) {
                 //todo: don't if property is disabled
                 addInputCharacter = keyPressed;
                 ImGui::SetKeyboardFocusHere();
@@ -2053,13 +2405,17 @@ void PropertyRowsUI(bool pr)
                 ImGui::TableSetColumnIndex(0);
                 ImGui::AlignTextToFramePadding();
             }
-            bool change = pr ? ctx.selected[0]->PropertyUI(i, ctx) : ctx.selected[0]->EventUI(i, ctx);
+            bool change = pr ? ctx->selected[0]->PropertyUI(row.index, *ctx) : ctx->selected[0]->EventUI(row.index, *ctx);
             if (change) {
                 fileTabs[activeTab].modified = true;
-                if (props[i].property) {
-                    copyChange = true;
-                    lastPropName = props[i].name; //todo: set lastPropName upon input focus as well
-                    pval = props[i].property->to_arg();
+                UINode::MarkEdited();
+                //values set from dialogs arrive later, index is updated lazily
+                for (UINode* node : ctx->selected)
+                    ctx->varUsage.Touch(node);
+                if (row.property) {
+                    changedRow = &row;
+                    lastPropName = row.name; //todo: set lastPropName upon input focus as well
+                    pval = row.property->to_arg();
                 }
             }
         }
@@ -2079,24 +2435,17 @@ void PropertyRowsUI(bool pr)
         else
             pgeHeight = ImGui::GetItemRectSize().y;
 
-        if (props.empty()) {
+        if (!model.count) {
             ImGui::Spacing();
             ImGui::Indent();
             ImGui::TextDisabled("%s", "Not available");
         }
 
         //copy changes to other widgets
-        if (copyChange)
+        if (changedRow)
         {
-            for (size_t i = 1; i < ctx.selected.size(); ++i)
-            {
-                auto props = pr ? ctx.selected[i]->Properties() : ctx.selected[i]->Events();
-                for (auto& p : props)
-                {
-                    if (p.name == lastPropName)
-                        p.property->set_from_arg(pval);
-                }
-            }
+            for (auto* slot : changedRow->slots)
+                slot->set_from_arg(pval);
         }
     }
     ImGui::PopItemFlag();
@@ -2166,46 +2515,74 @@ void PopupUI()
 
 void Draw()
 {
-    if (reloadStyle) //eliminates flicker
-        return;
-    if (activeTab < 0)
+    if (reloadStyle || activeTab < 0 || !IsDesignStyleLoaded(fileTabs[activeTab])) { //eliminates flicker
+        ctx->drawCache.Invalidate();
         return;
+    }
     auto& file = fileTabs[activeTab];
     auto& cfg = file.configs[file.activeConfig];
-    if (!cfg.rootNode)
+    if (!cfg.rootNode) {
+        ctx->drawCache.Invalidate();
         return;
+    }
 
-    auto tmpStyle = ImGui::GetStyle();
-    ImGui::GetStyle() = ctx.style;
-    ImGui::GetStyle().Colors[ImGuiCol_TitleBg] = ImGui::GetStyle().Colors[ImGuiCol_TitleBgActive];
-    ImGui::GetStyle().ScaleAllSizes(zoomFactor);
-    ImGui::GetStyle().FontScaleDpi *= zoomFactor;
-    ImGui::PushFont(ctx.defaultStyleFont); //ctx.defaultStyleFont.fontSize is correct
+    //DrawCache checks input events itself so only hash what can change without them
+    //model edits from dialogs and imports arrive through the generations
+    ImU32 cacheKey = 0;
+    HashCombineData(cacheKey, cfg.rootNode.get());
+    HashCombineData(cacheKey, UINode::editGeneration);
+    HashCombineData(cacheKey, UINode::instanceGeneration);
+    for (UINode* node : ctx->selected)
+        HashCombineData(cacheKey, node);
+    HashCombineData(cacheKey, ctx->mode);
+    HashCombineData(cacheKey, zoomFactor);
+    HashCombineData(cacheKey, ctx->showUntranslated);
+    HashCombineData(cacheKey, ctx->designAreaMin);
+    HashCombineData(cacheKey, ctx->designAreaMax);
+    HashCombineData(cacheKey, ImGui::GetIO().Fonts->TexData->UniqueID); //atlas repacked
+    HashCombineData(cacheKey, textureCache.Revision()); //Image loaded
+    cacheKey = ImHashStr(cfg.styleName.c_str(), 0, cacheKey);
+    cacheKey = ImHashStr(cfg.unit.c_str(), 0, cacheKey);
+    ctx->drawCache.Update(cacheKey);
+
+    //scaling is done only when zoom or style changes
+    if (file.designStyleZoom != zoomFactor)
+    {
+        file.designStyleZoom = zoomFactor;
+        file.designStyle = ctx->style;
+        file.designStyle.Colors[ImGuiCol_TitleBg] = file.designStyle.Colors[ImGuiCol_TitleBgActive];
+        file.designStyle.ScaleAllSizes(zoomFactor);
+        file.designStyle.FontScaleDpi *= zoomFactor;
+    }
+    //ImGui keeps style by value, a swap would cost three copies so it's assigned
+    //here and restored from appStyle below
+    ImGui::GetStyle() = file.designStyle;
+    ImGui::PushFont(ctx->defaultStyleFont); //ctx->defaultStyleFont.fontSize is correct
     float tmpDpiScale = ImRad::GetUserData().dpiScale;
     if (cfg.unit == "dp")
-        ImRad::GetUserData().dpiScale = ctx.style.FontScaleDpi * zoomFactor;
+        ImRad::GetUserData().dpiScale = ctx->style.FontScaleDpi * zoomFactor;
     else
         ImRad::GetUserData().dpiScale = zoomFactor;
 
-    ctx.appStyle = &tmpStyle;
-    ctx.workingDir = u8string(u8path(file.fname).parent_path());
-    ctx.unit = cfg.unit;
-    ctx.modified = &file.modified;
-    ctx.allRoots.clear();
+    ctx->appStyle = &appStyle;
+    ctx->workingDir = u8string(u8path(file.fname).parent_path());
+    ctx->unit = cfg.unit;
+    ctx->modified = &file.modified;
+    ctx->allRoots.clear();
     for (const auto& cfg : file.configs)
-        ctx.allRoots.push_back(cfg.rootNode.get());
+        ctx->allRoots.push_back(cfg.rootNode.get());
 
-    cfg.rootNode->Draw(ctx);
+    cfg.rootNode->Draw(*ctx);
 
-    if (ctx.isAutoSize && ctx.layoutHash != ctx.prevLayoutHash)
+    if (ctx->isAutoSize && ctx->layoutHash != ctx->prevLayoutHash)
     {
-        ctx.root->ResetLayout();
-        if (ctx.rootWin)
-            ctx.rootWin->HiddenFramesCannotSkipItems = 2; //flicker removal
+        ctx->root->ResetLayout();
+        if (ctx->rootWin)
+            ctx->rootWin->HiddenFramesCannotSkipItems = 2; //flicker removal
     }
 
     ImGui::PopFont();
-    ImGui::GetStyle() = std::move(tmpStyle);
+    ImGui::GetStyle() = appStyle;
     ImRad::GetUserData().dpiScale = tmpDpiScale;
 }
 
@@ -2252,12 +2629,13 @@ RemoveSelected()
 {
     auto& tab = fileTabs[activeTab];
     auto& rootNode = tab.configs[tab.activeConfig].rootNode;
-    std::vector<UINode*> sortedSel = SortSelection(ctx.selected);
+    std::vector<UINode*> sortedSel = SortSelection(ctx->selected);
     if (sortedSel.empty())
         return {};
 
     std::vector<std::unique_ptr<Widget>> remove;
     tab.modified = true;
+    UINode::MarkEdited(true);
     auto pi1 = rootNode->FindChild(sortedSel[0]);
     for (UINode* node : sortedSel)
     {
@@ -2266,7 +2644,7 @@ RemoveSelected()
         remove.push_back(std::move(parent->children[pi->second]));
         parent->children.erase(parent->children.begin() + pi->second);
         if (pi->second < parent->children.size() &&
-            !stx::count(ctx.selected, parent->children[pi->second].get()) &&
+            !stx::count(ctx->selected, parent->children[pi->second].get()) &&
             (parent->children[pi->second]->Behavior() & UINode::SnapSides))
         {
             Widget* child = dynamic_cast<Widget*>(remove.back().get());
@@ -2284,15 +2662,15 @@ RemoveSelected()
     {
         UINode* parent1 = pi1->first;
         if (pi1->second < parent1->children.size())
-            ctx.selected = { parent1->children[pi1->second].get() };
+            ctx->selected = { parent1->children[pi1->second].get() };
         else if (pi1->second)
-            ctx.selected = { parent1->children[pi1->second - 1].get() };
+            ctx->selected = { parent1->children[pi1->second - 1].get() };
         else
-            ctx.selected = { parent1 };
+            ctx->selected = { parent1 };
     }
     else
     {
-        ctx.selected.clear();
+        ctx->selected.clear();
     }
 
     return remove;
@@ -2381,83 +2759,84 @@ void Work()
         CloseFile();
     }
 
-    if (ctx.mode == UIContext::PickPoint)
+    if (ctx->mode == UIContext::PickPoint)
     {
         ImGui::SetMouseCursor(ImGuiMouseCursor_Hand);
         SetCrossCursor();
 
         if (ImGui::IsKeyPressed(ImGuiKey_Escape))
         {
-            ctx.mode = UIContext::NormalSelection;
+            ctx->mode = UIContext::NormalSelection;
             activeButton = "";
         }
         else if (!ImGui::GetIO().KeyCtrl)
         {
-            ctx.mode = UIContext::SnapInsert;
+            ctx->mode = UIContext::SnapInsert;
         }
         else if (ImGui::IsMouseReleased(ImGuiMouseButton_Left) &&
-            ctx.snapParent)
+            ctx->snapParent)
         {
             if (activeButton == "") {
                 newNode = std::move(clipboard.back());
                 clipboard.pop_back();
             }
 
-            const float dp = ctx.style.FontScaleDpi * zoomFactor;
+            const float dp = ctx->style.FontScaleDpi * zoomFactor;
             newNode->hasPos = 0;
-            ImVec2 pos = ImGui::GetMousePos() - ctx.snapParent->cached_pos;
-            if (pos.x < ctx.snapParent->cached_size.x / 2) {
+            ImVec2 pos = ImGui::GetMousePos() - ctx->snapParent->cached_pos;
+            if (pos.x < ctx->snapParent->cached_size.x / 2) {
                 newNode->hasPos |= ImRad::AlignLeft;
                 newNode->pos_x = pos.x / dp;
             }
             else {
                 newNode->hasPos |= ImRad::AlignRight;
-                newNode->pos_x = (pos.x - ctx.snapParent->cached_size.x) / dp;
+                newNode->pos_x = (pos.x - ctx->snapParent->cached_size.x) / dp;
             }
-            if (pos.y < ctx.snapParent->cached_size.y / 2) {
+            if (pos.y < ctx->snapParent->cached_size.y / 2) {
                 newNode->hasPos |= ImRad::AlignTop;
                 newNode->pos_y = pos.y / dp;
             }
             else {
                 newNode->hasPos |= ImRad::AlignBottom;
-                newNode->pos_y = (pos.y - ctx.snapParent->cached_size.y) / dp;
+                newNode->pos_y = (pos.y - ctx->snapParent->cached_size.y) / dp;
             }
-            ctx.selected = { newNode.get() };
-            ctx.snapParent->children.push_back(std::move(newNode));
-            ctx.mode = UIContext::NormalSelection;
+            ctx->selected = { newNode.get() };
+            ctx->snapParent->children.push_back(std::move(newNode));
+            ctx->mode = UIContext::NormalSelection;
 
             if (activeButton == "") {
                 //push pasted widget copy to clipboard (vars may change)
-                auto clone = ctx.snapParent->children.back()->Clone(ctx);
+                auto clone = ctx->snapParent->children.back()->Clone(*ctx);
                 clipboard.push_back(std::move(clone));
             }
             activeButton = "";
             file->modified = true;
+            UINode::MarkEdited(true);
             ImGui::GetIO().MouseReleased[ImGuiMouseButton_Left] = false; //eat event
         }
     }
-    else if (ctx.mode == UIContext::SnapInsert || ctx.mode == UIContext::SnapMove)
+    else if (ctx->mode == UIContext::SnapInsert || ctx->mode == UIContext::SnapMove)
     {
         if (ImGui::IsKeyPressed(ImGuiKey_Escape))
         {
-            ctx.mode = UIContext::NormalSelection;
+            ctx->mode = UIContext::NormalSelection;
             activeButton = "";
         }
-        else if (ctx.mode == UIContext::SnapInsert && //todo: SnapMove
+        else if (ctx->mode == UIContext::SnapInsert && //todo: SnapMove
             ImGui::GetIO().KeyCtrl &&
             (activeButton == "" || (newNode->Behavior() & UINode::SnapSides)))
         {
-            ctx.mode = UIContext::PickPoint;
+            ctx->mode = UIContext::PickPoint;
         }
         else if (ImGui::IsMouseReleased(ImGuiMouseButton_Left))  //MouseReleased to avoid confusing RectSelection
         {
-            if (!ctx.snapParent && ctx.mode == UIContext::SnapMove)
+            if (!ctx->snapParent && ctx->mode == UIContext::SnapMove)
             {
-                ctx.mode = UIContext::NormalSelection;
+                ctx->mode = UIContext::NormalSelection;
                 ImGui::GetIO().MouseReleased[ImGuiMouseButton_Left] = false; //eat event
                 return;
             }
-            else if (!ctx.snapParent)
+            else if (!ctx->snapParent)
             {
                 return;
             }
@@ -2465,20 +2844,20 @@ void Work()
             int n;
             std::unique_ptr<Widget>* newNodes;
             std::vector<std::unique_ptr<Widget>> tmpMoved;
-            if (ctx.mode == UIContext::SnapMove)
+            if (ctx->mode == UIContext::SnapMove)
             {
-                assert(ctx.selected.size() == 1);
-                auto pinfo = rootNode->FindChild(ctx.selected[0]);
-                auto chinfo = ctx.selected[0]->FindChild(ctx.snapParent);
+                assert(ctx->selected.size() == 1);
+                auto pinfo = rootNode->FindChild(ctx->selected[0]);
+                auto chinfo = ctx->selected[0]->FindChild(ctx->snapParent);
                 if (chinfo) {
                     //disallow moving into its child
-                    ctx.mode = UIContext::NormalSelection;
+                    ctx->mode = UIContext::NormalSelection;
                     ImGui::GetIO().MouseReleased[ImGuiMouseButton_Left] = false; //eat event
                     return;
                 }
-                if (pinfo->first == ctx.snapParent && ctx.snapIndex > pinfo->second) {
+                if (pinfo->first == ctx->snapParent && ctx->snapIndex > pinfo->second) {
                     //compensate removeSelected operation
-                    --ctx.snapIndex;
+                    --ctx->snapIndex;
                 }
                 tmpMoved = RemoveSelected();
                 n = (int)tmpMoved.size();
@@ -2498,30 +2877,30 @@ void Work()
             if (n)
             {
                 bool firstItem = true;
-                for (size_t i = 0; i < ctx.snapIndex; ++i)
+                for (size_t i = 0; i < ctx->snapIndex; ++i)
                 {
-                    auto* ch = ctx.snapParent->children[i].get();
+                    auto* ch = ctx->snapParent->children[i].get();
                     if (!ch->hasPos && (ch->Behavior() & UINode::SnapSides))
                         firstItem = false;
                 }
-                newNodes[0]->sameLine = ctx.snapSameLine;
+                newNodes[0]->sameLine = ctx->snapSameLine;
                 newNodes[0]->spacing = firstItem ? 0 : 1;
-                newNodes[0]->nextColumn = ctx.snapNextColumn;
+                newNodes[0]->nextColumn = ctx->snapNextColumn;
                 //reset hasPos, nextColumn
                 for (size_t i = 0; i < n; ++i)
                 {
                     newNodes[i]->hasPos = ImRad::AlignNone;
                 }
-                if (ctx.snapParent->ColumnCount(ctx) <= 1)
+                if (ctx->snapParent->ColumnCount(*ctx) <= 1)
                 {
                     for (size_t i = 1; i < n; ++i)
                         newNodes[i]->nextColumn = 0;
                 }
             }
-            if (ctx.snapIndex < ctx.snapParent->children.size())
+            if (ctx->snapIndex < ctx->snapParent->children.size())
             {
-                auto& next = ctx.snapParent->children[ctx.snapIndex];
-                if (ctx.snapUseNextSpacing) {
+                auto& next = ctx->snapParent->children[ctx->snapIndex];
+                if (ctx->snapUseNextSpacing) {
                     newNodes[0]->nextColumn = next->nextColumn;
                     newNodes[0]->spacing = next->spacing;
                     newNodes[0]->indent = next->indent;
@@ -2529,17 +2908,17 @@ void Work()
                     next->spacing = 1;
                     next->indent = 0;
                 }
-                if (ctx.snapSetNextSameLine) {
+                if (ctx->snapSetNextSameLine) {
                     next->sameLine = true;
                 }
                 if (next->sameLine)
                     next->indent = 0; //otherwise creates widgets overlaps
             }
-            ctx.selected.clear();
-            if (ctx.mode == UIContext::SnapMove || activeButton != "")
+            ctx->selected.clear();
+            if (ctx->mode == UIContext::SnapMove || activeButton != "")
             {
-                ctx.selected.push_back(newNodes[0].get());
-                ctx.snapParent->children.insert(ctx.snapParent->children.begin() + ctx.snapIndex, std::move(newNodes[0]));
+                ctx->selected.push_back(newNodes[0].get());
+                ctx->snapParent->children.insert(ctx->snapParent->children.begin() + ctx->snapIndex, std::move(newNodes[0]));
             }
             else
             {
@@ -2547,15 +2926,16 @@ void Work()
                 {
                     //paste original widgets and push cloned widgets back to the clipboard
                     //so original variables will be used in a pasted widget
-                    auto wdg = newNodes[i]->Clone(ctx);
-                    ctx.selected.push_back(newNodes[i].get());
-                    ctx.snapParent->children.insert(ctx.snapParent->children.begin() + ctx.snapIndex + i, std::move(newNodes[i]));
+                    auto wdg = newNodes[i]->Clone(*ctx);
+                    ctx->selected.push_back(newNodes[i].get());
+                    ctx->snapParent->children.insert(ctx->snapParent->children.begin() + ctx->snapIndex + i, std::move(newNodes[i]));
                     newNodes[i] = std::move(wdg);
                 }
             }
-            ctx.mode = UIContext::NormalSelection;
+            ctx->mode = UIContext::NormalSelection;
             activeButton = "";
             file->modified = true;
+            UINode::MarkEdited(true);
             ImGui::GetIO().MouseReleased[ImGuiMouseButton_Left] = false; //eat event
         }
     }
@@ -2580,23 +2960,23 @@ void Work()
                 RemoveSelected();
             }
             if (ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_C, ImGuiInputFlags_RouteGlobal) &&
-                !ctx.selected.empty() &&
-                ctx.selected[0] != rootNode)
+                !ctx->selected.empty() &&
+                ctx->selected[0] != rootNode)
             {
                 clipboard.clear();
-                bool tmp = ctx.createVars;
-                ctx.createVars = false;
-                auto sortedSel = SortSelection(ctx.selected);
+                bool tmp = ctx->createVars;
+                ctx->createVars = false;
+                auto sortedSel = SortSelection(ctx->selected);
                 for (UINode* node : sortedSel)
                 {
                     auto* wdg = dynamic_cast<Widget*>(node);
-                    clipboard.push_back(wdg->Clone(ctx));
+                    clipboard.push_back(wdg->Clone(*ctx));
                 }
-                ctx.createVars = tmp;
+                ctx->createVars = tmp;
             }
             if (ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_X, ImGuiInputFlags_RouteGlobal) &&
-                !ctx.selected.empty() &&
-                ctx.selected[0] != rootNode)
+                !ctx->selected.empty() &&
+                ctx->selected[0] != rootNode)
             {
                 clipboard = RemoveSelected();
             }
@@ -2604,21 +2984,23 @@ void Work()
                 clipboard.size())
             {
                 activeButton = "";
-                ctx.mode = UIContext::SnapInsert;
-                ctx.selected = {};
+                ctx->mode = UIContext::SnapInsert;
+                ctx->selected = {};
             }
             if (ImGui::Shortcut(ImGuiMod_Alt | ImGuiKey_LeftArrow, ImGuiInputFlags_RouteGlobal) &&
-                ctx.selected.size() == 1 &&
-                (ctx.selected[0]->Behavior() & UINode::SnapSides))
+                ctx->selected.size() == 1 &&
+                (ctx->selected[0]->Behavior() & UINode::SnapSides))
             {
-                auto pos = ctx.root->FindChild(ctx.selected[0]);
+                auto pos = ctx->root->FindChild(ctx->selected[0]);
                 if (!pos)
                     return;
                 UINode* parent = pos->first;
+                file->modified = true;
+                UINode::MarkEdited(); //sameLine, nextColumn or order changes
                 auto* child = parent->children[pos->second].get();
                 auto* left = pos->second ? parent->children[pos->second - 1].get() : nullptr;
                 auto* right = pos->second + 1 < parent->children.size() ? parent->children[pos->second + 1].get() : nullptr;
-                int ncols = parent->ColumnCount(ctx);
+                int ncols = parent->ColumnCount(*ctx);
                 int col = 0;
                 if (ncols >= 2) {
                     for (size_t j = 0; j <= pos->second; ++j)
@@ -2670,16 +3052,18 @@ void Work()
                 }
             }
             if (ImGui::Shortcut(ImGuiMod_Alt | ImGuiKey_RightArrow, ImGuiInputFlags_RouteGlobal) &&
-                ctx.selected.size() == 1 &&
-                (ctx.selected[0]->Behavior() & UINode::SnapSides))
+                ctx->selected.size() == 1 &&
+                (ctx->selected[0]->Behavior() & UINode::SnapSides))
             {
-                auto pos = ctx.root->FindChild(ctx.selected[0]);
+                auto pos = ctx->root->FindChild(ctx->selected[0]);
                 if (!pos)
                     return;
                 UINode* parent = pos->first;
+                file->modified = true;
+                UINode::MarkEdited(); //sameLine, nextColumn or order changes
                 auto* child = parent->children[pos->second].get();
                 auto* right = pos->second + 1 < parent->children.size() ? parent->children[pos->second + 1].get() : nullptr;
-                int ncols = parent->ColumnCount(ctx);
+                int ncols = parent->ColumnCount(*ctx);
                 int col = 0;
                 if (ncols >= 2) {
                     for (size_t j = 0; j <= pos->second; ++j)
@@ -2971,13 +3355,14 @@ int main(int argc, const char* argv[])
     ImGui_ImplGlfw_InitForOpenGL(glfwWindow, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
     const ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
-    ctx.dashTexId = ImRad::LoadTextureFromFile(
+    appCtx.dashTexId = ImRad::LoadTextureFromFile(
         (rootPath + "/style/dash.png").c_str(), false, false, true, true).id;
 
     NFD_Init();
     GetStyles();
     programState = (ProgramState)-1;
     bool lastVisible = true;
+    fileWatcher.Start();
     InitStylesWatcher();
 
     while (true)
@@ -3005,7 +3390,7 @@ int main(int argc, const char* argv[])
             else
             {
                 programState = Shutdown;
-                ctx.mode = UIContext::NormalSelection;
+                ctx->mode = UIContext::NormalSelection;
                 //save state before files close
                 ImGui::SaveIniSettingsToDisk(ImGui::GetIO().IniFilename);
                 ImGui::GetIO().IniFilename = nullptr;
@@ -3030,9 +3415,11 @@ int main(int argc, const char* argv[])
         ImGui::NewFrame();
 
         bool visible = glfwGetWindowAttrib(glfwWindow, GLFW_FOCUSED);
-        if (visible && !lastVisible)
+        if (visible && !lastVisible && !fileWatcher.Active())
             ReloadFile();
         lastVisible = visible;
+        ProcessFileChanges();
+        textureCache.Update();
 
         DockspaceUI();
         ToolbarUI();
@@ -3058,6 +3445,9 @@ int main(int argc, const char* argv[])
     }
 
     // Cleanup
+    fileWatcher.Stop();
+    StopExplorer();
+    textureCache.Stop();
     NFD_Quit();
 
     ImGui_ImplOpenGL3_Shutdown();
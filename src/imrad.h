@@ -252,14 +252,42 @@ IOUserData& GetUserData();
 
 void SaveStyle(const std::string& spath, const ImGuiStyle* src = nullptr, const std::map<std::string, std::string>& extra = {});
 
+//Like ImFontAtlas::AddFontFromFileTTF but file contents are read only once and shared
+//by later calls so fonts can be rebuilt after style change without disk access
+ImFont* AddFontFromFileCached(const std::string& path, float size, const ImFontConfig* cfg = nullptr);
+
 //This function can be used in your code to load style and fonts from the INI file
+//When an up to date compiled style (.stylebin) is found next to it, it is loaded instead
 void LoadStyle(const std::string& spath, float fontScaling = 1, ImGuiStyle* dst = nullptr, std::map<std::string, ImFont*>* fontMap = nullptr, std::map<std::string, std::string>* extra = nullptr);
 
+//Writes the compiled form of an INI style next to it. It contains ImGuiStyle as binary
+//and is only used by the same ImGui version, otherwise LoadStyle falls back to the INI
+void CompileStyle(const std::string& spath);
+
+//Checks the compiled style was built from current INI content by this ImGui version
+bool IsStyleCompiled(const std::string& spath);
+
 //------------------------------------------------------------------------
 
-bool Combo(const char* label, std::string* curr, const std::vector<std::string>& items, int flags = 0);
+//Optional lookup for Combo with large item lists
+//Keeps item offsets of the packed "a\0b\0" form and a sorted order for the type-ahead filter
+//It is rebuilt when items location, count or packed content changes.
+//Call Reset() after modifying vector items in place
+struct ComboIndex
+{
+    void Reset() { source = nullptr; }
+
+    const void* source = nullptr;
+    size_t count = 0;
+    ImGuiID hash = 0; //packed form content
+    std::vector<int> offsets;
+    std::vector<int> sorted;
+    std::string filter;
+};
+
+bool Combo(const char* label, std::string* curr, const std::vector<std::string>& items, int flags = 0, ComboIndex* index = nullptr);
 
-bool Combo(const char* label, std::string* curr, const char* items, int flags = 0);
+bool Combo(const char* label, std::string* curr, const char* items, int flags = 0, ComboIndex* index = nullptr);
 
 // from imgui_internal.h
 using SeparatorFlags = int;
@@ -403,6 +431,45 @@ void RenderDimmedBackground(const Rect& rect, float alpha_mul);
 
 void RenderFilledWindowCorners(ImDrawFlags fl);
 
+#ifdef IMGUI_HAS_DOCK
+//one split of a generated dock layout, nodes are listed in split order
+//parent is the index of the node being split or -1 for the remaining dockspace node
+//and it receives the remaining part just like DockBuilderSplitNode's out_id_other
+struct DockLayoutNode
+{
+    int parent;
+    ImGuiDir dir;
+    float ratio;
+    int flags; //ImGuiDockNodeFlags
+    const char* windows; //docked window names separated by '\n'
+};
+
+template <size_t N>
+struct DockLayout
+{
+    DockLayoutNode nodes[N];
+};
+
+template <size_t N>
+constexpr DockLayout<N> MakeDockLayout(const DockLayoutNode (&nodes)[N])
+{
+    DockLayout<N> layout{};
+    for (size_t i = 0; i < N; ++i)
+        layout.nodes[i] = nodes[i];
+    return layout;
+}
+
+//builds the dock tree unless dockId already exists which happens after the first
+//call or when it was restored from saved settings. Returns true when it was built
+bool ApplyDockLayout(ImGuiID dockId, const ImVec2& size, const DockLayoutNode* nodes, size_t count);
+
+template <size_t N>
+bool ApplyDockLayout(ImGuiID dockId, const ImVec2& size, const DockLayout<N>& layout)
+{
+    return ApplyDockLayout(dockId, size, layout.nodes, N);
+}
+#endif
+
 //-------------------------------------------------------------------------
 
 #ifdef IMRAD_WITH_FMT
@@ -492,10 +559,36 @@ std::string VFormat(const char* fmt, A&&... args)
 
 #endif
 
+//Loads GNU .mo message catalog used by Translate. Empty path unloads it.
+//Without a catalog Translate falls back to gettext when IMRAD_WITH_GETTEXT is defined.
+//Lookups hash the passed string and don't allocate or retain it
+bool LoadTranslation(const std::string& moPath);
+
 const char* Translate(const char* text);
 
 const char* Translate(const char* context, const char* text);
 
+//Translated string cached for one call site. It's refreshed only after LoadTranslation
+//so generated Draw code doesn't search the catalog every frame
+struct TrCache
+{
+    const char* str = nullptr;
+    int generation = -1;
+};
+
+//Every lambda has its own type so ImRad::CallSite([]{}) gives each call site its own cache
+template <class F>
+TrCache& CallSite(F)
+{
+    static TrCache cache;
+    return cache;
+}
+
+//text must not change between calls, generated code passes string literals
+const char* Translate(TrCache& cache, const char* text);
+
+const char* Translate(TrCache& cache, const char* context, const char* text);
+
 const char* Translate(const char* text, const char* plural, int n);
 
 const char* Translate(const char* context, const char* text, const char* plural, int n);
@@ -509,9 +602,15 @@ const char* Translate(const char* context, const char* text, const char* plural,
 #ifdef IMRAD_H_IMPLEMENTATION
 
 #include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
 #include <iomanip>
+#include <iterator>
 #include <sstream>
 #include <imgui_internal.h> //CurrentItemFlags, GetCurrentWindow, GetCurrentContext, PushOverrideID
 
@@ -527,6 +626,16 @@ const char* Translate(const char* context, const char* text, const char* plural,
 #include <libintl.h>
 #endif
 
+#if !defined(_WIN32) && !defined(ANDROID)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <unordered_map>
+#include <string_view>
+
 namespace ImRad
 {
 
@@ -745,35 +854,133 @@ float BoxLayout<HORIZ>::GetSize()
 template struct BoxLayout<true>;
 template struct BoxLayout<false>;
 
-bool Combo(const char* label, std::string* curr, const std::vector<std::string>& items, int flags)
+//compares item prefix ignoring case, item can be shorter than prefix
+inline int ComparePrefixNoCase(const char* item, const std::string& prefix)
+{
+    for (size_t i = 0; i < prefix.size(); ++i) {
+        int a = std::tolower((unsigned char)item[i]);
+        int b = std::tolower((unsigned char)prefix[i]);
+        if (a != b)
+            return a - b;
+    }
+    return 0;
+}
+
+//draws items of an open combo through a clipper
+//with index the items can be filtered by typing a prefix
+template <class F>
+bool ComboItems(std::string* curr, int count, F&& getItem, ComboIndex* index)
 {
     bool changed = false;
-    if (ImGui::BeginCombo(label, curr->c_str(), flags))
+    int first = 0, last = count;
+    bool filtered = false;
+    if (index)
+    {
+        if ((int)index->sorted.size() != count) {
+            index->sorted.resize(count);
+            for (int i = 0; i < count; ++i)
+                index->sorted[i] = i;
+            std::sort(index->sorted.begin(), index->sorted.end(), [&](int a, int b) {
+                const char* pa = getItem(a);
+                const char* pb = getItem(b);
+                return std::lexicographical_compare(pa, pa + strlen(pa), pb, pb + strlen(pb),
+                    [](char x, char y) { return std::tolower((unsigned char)x) < std::tolower((unsigned char)y); });
+                });
+        }
+        if (ImGui::IsWindowAppearing()) {
+            index->filter.clear();
+            ImGui::SetKeyboardFocusHere();
+        }
+        ImGui::SetNextItemWidth(-1);
+        ImGui::InputTextWithHint("##filter", "Search...", &index->filter);
+        if (index->filter.size())
+        {
+            filtered = true;
+            auto range = std::equal_range(index->sorted.begin(), index->sorted.end(), -1, [&](int a, int b) {
+                //-1 stands for the filter
+                if (a < 0)
+                    return ComparePrefixNoCase(getItem(b), index->filter) > 0;
+                return ComparePrefixNoCase(getItem(a), index->filter) < 0;
+                });
+            first = int(range.first - index->sorted.begin());
+            last = int(range.second - index->sorted.begin());
+        }
+    }
+
+    ImGuiListClipper clipper;
+    clipper.Begin(last - first);
+    int currIdx = -1;
+    if (!filtered && ImGui::IsWindowAppearing()) {
+        for (int i = 0; i < count && currIdx < 0; ++i)
+            if (!curr->compare(getItem(i)))
+                currIdx = i;
+        if (currIdx >= 0)
+            clipper.IncludeItemByIndex(currIdx);
+    }
+    while (clipper.Step())
     {
-        for (const auto& item : items) {
-            if (ImGui::Selectable(item.c_str(), item == *curr)) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            int idx = filtered ? index->sorted[first + i] : i;
+            const char* item = getItem(idx);
+            ImGui::PushID(idx);
+            if (ImGui::Selectable(item, !curr->compare(item))) {
                 *curr = item;
                 changed = true;
             }
+            if (idx == currIdx)
+                ImGui::SetScrollHereY();
+            ImGui::PopID();
+        }
+    }
+    return changed;
+}
+
+bool Combo(const char* label, std::string* curr, const std::vector<std::string>& items, int flags, ComboIndex* index)
+{
+    bool changed = false;
+    if (ImGui::BeginCombo(label, curr->c_str(), flags))
+    {
+        if (index && (index->source != items.data() || index->count != items.size())) {
+            index->source = items.data();
+            index->count = items.size();
+            index->sorted.clear();
         }
+        changed = ComboItems(curr, (int)items.size(), [&](int i) { return items[i].c_str(); }, index);
         ImGui::EndCombo();
     }
     return changed;
 }
 
-bool Combo(const char* label, std::string* curr, const char* items, int flags)
+bool Combo(const char* label, std::string* curr, const char* items, int flags, ComboIndex* index)
 {
     bool changed = false;
     if (ImGui::BeginCombo(label, curr->c_str(), flags))
     {
-        const char* p = items;
-        while (*p) {
-            if (ImGui::Selectable(p, !curr->compare(p))) {
-                *curr = p;
-                changed = true;
+        //reused so frames without index don't allocate
+        static std::vector<int> scratch;
+        std::vector<int>& offsets = index ? index->offsets : scratch;
+        ImGuiID hash = 0;
+        if (index) {
+            //content hash catches items edited in place at the same address
+            const char* end = items;
+            while (*end)
+                end += strlen(end) + 1;
+            hash = ImHashData(items, end - items);
+        }
+        if (!index || index->source != items || index->hash != hash)
+        {
+            offsets.clear();
+            for (const char* p = items; *p; p += strlen(p) + 1)
+                offsets.push_back(int(p - items));
+            if (index) {
+                index->source = items;
+                index->count = offsets.size();
+                index->hash = hash;
+                index->sorted.clear();
             }
-            p += strlen(p) + 1;
         }
+        changed = ComboItems(curr, (int)offsets.size(), [&](int i) { return items + offsets[i]; }, index);
         ImGui::EndCombo();
     }
     return changed;
@@ -1335,6 +1542,39 @@ void RenderFilledWindowCorners(ImDrawFlags fl)
     ImGui::PopClipRect();
 }
 
+#ifdef IMGUI_HAS_DOCK
+bool ApplyDockLayout(ImGuiID dockId, const ImVec2& size, const DockLayoutNode* nodes, size_t count)
+{
+    if (ImGui::DockBuilderGetNode(dockId))
+        return false;
+
+    ImGuiID rootId = ImGui::DockBuilderAddNode(dockId, ImGuiDockNodeFlags_DockSpace);
+    ImGui::DockBuilderSetNodeSize(rootId, size);
+    std::vector<ImGuiID> ids(count);
+    std::string name;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const DockLayoutNode& node = nodes[i];
+        ImGuiID& parentId = node.parent < 0 || (size_t)node.parent >= i ? rootId : ids[node.parent];
+        ids[i] = ImGui::DockBuilderSplitNode(parentId, node.dir, node.ratio, nullptr, &parentId);
+        if (node.flags)
+            ImGui::DockBuilderGetNode(ids[i])->LocalFlags = node.flags;
+
+        for (const char* s = node.windows; s && *s; )
+        {
+            const char* e = std::strchr(s, '\n');
+            if (!e)
+                e = s + std::strlen(s);
+            name.assign(s, e);
+            ImGui::DockBuilderDockWindow(name.c_str(), ids[i]);
+            s = *e ? e + 1 : e;
+        }
+    }
+    ImGui::DockBuilderFinish(dockId);
+    return true;
+}
+#endif
+
 #ifdef IMRAD_WITH_MINIZIP
 std::vector<uint8_t> UnzipAssetData(const std::string& url)
 {
@@ -1560,20 +1800,55 @@ void SaveStyle(const std::string& spath, const ImGuiStyle* src, const std::map<s
     }
 }
 
-void LoadStyle(const std::string& spath, float fontScaling, ImGuiStyle* dst, std::map<std::string, ImFont*>* fontMap, std::map<std::string, std::string>* extra)
+ImFont* AddFontFromFileCached(const std::string& path, float size, const ImFontConfig* cfg)
 {
-    ImGuiStyle* style = dst ? dst : &ImGui::GetStyle();
-    *style = ImGuiStyle();
-    auto& io = ImGui::GetIO();
+    struct Entry {
+        std::filesystem::file_time_type time;
+        std::vector<char> data;
+    };
+    static std::map<std::string, std::unique_ptr<Entry>> cache;
+    static std::vector<std::unique_ptr<Entry>> retired; //atlas can still reference old data
 
-    auto stylePath = u8path(spath);
-    std::ifstream fin(stylePath);
-    if (!fin)
-        throw std::runtime_error("Can't read " + stylePath.string());
+    std::error_code err;
+    auto time = std::filesystem::last_write_time(u8path(path), err);
+    auto& entry = cache[path];
+    if (!entry || entry->time != time)
+    {
+        std::ifstream fin(u8path(path), std::ios::binary);
+        if (!fin)
+            return nullptr;
+        auto e = std::make_unique<Entry>();
+        e->time = time;
+        e->data.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+        if (e->data.empty())
+            return nullptr;
+        if (entry)
+            retired.push_back(std::move(entry));
+        entry = std::move(e);
+    }
+
+    ImFontConfig fcfg = cfg ? *cfg : ImFontConfig();
+    fcfg.FontDataOwnedByAtlas = false;
+    if (!fcfg.Name[0]) //same as AddFontFromFileTTF
+        snprintf(fcfg.Name, sizeof(fcfg.Name), "%s", u8string(u8path(path).filename()).c_str());
+    return ImGui::GetIO().Fonts->AddFontFromMemoryTTF(entry->data.data(), (int)entry->data.size(), size, &fcfg);
+}
+
+struct StyleFont
+{
+    std::string key;
+    std::string fname;
+    float size = 0;
+    ImVec2 goffset;
+    bool hasRange = false;
+    ImWchar range[2] = { 0, 0 };
+};
+
+static void ParseStyleIni(std::istream& fin, ImGuiStyle* style, std::vector<StyleFont>& fonts, std::map<std::string, std::string>* extra)
+{
     std::string line;
     std::string cat;
     int lastClr = -1;
-    std::string lastFont;
     while (std::getline(fin, line))
     {
         if (line.empty() || line[0] == ';' || line[0] == '#')
@@ -1658,79 +1933,278 @@ void LoadStyle(const std::string& spath, float fontScaling, ImGuiStyle* dst, std
             }
             else if (cat == "fonts")
             {
-                std::string fname;
-                float size = 0.f;
-                ImVec2 goffset;
-                bool hasRange = false;
-                static std::vector<std::unique_ptr<ImWchar[]>> rngs;
-
-                is >> std::quoted(fname);
+                StyleFont font;
+                font.key = key;
+                is >> std::quoted(font.fname);
                 std::string tmp;
                 while (is >> tmp)
                 {
                     if (tmp == "size")
-                        is >> size;
+                        is >> font.size;
                     else if (tmp == "range") {
-                        hasRange = true;
-                        //needs to outlive this function
-                        rngs.push_back(std::unique_ptr<ImWchar[]>(new ImWchar[3]));
-                        is >> rngs.back()[0] >> rngs.back()[1];
-                        rngs.back()[2] = 0;
+                        font.hasRange = true;
+                        is >> font.range[0] >> font.range[1];
                     }
                     else if (tmp == "goffset") {
-                        is >> goffset.x >> goffset.y;
+                        is >> font.goffset.x >> font.goffset.y;
                     }
                 }
+                fonts.push_back(std::move(font));
+            }
+            else if (extra)
+            {
+                (*extra)[cat + "." + key] = is.str();
+            }
+        }
+    }
+}
+
+//compiled style layout:
+//  header, raw ImGuiStyle, fonts, extra
+//each string is prefixed with uint32 length
+struct StyleBinHeader
+{
+    char magic[4] = { 'I', 'R', 'S', 'B' };
+    uint32_t version = 2;
+    uint32_t imguiVersion = IMGUI_VERSION_NUM;
+    uint32_t styleSize = sizeof(ImGuiStyle);
+    uint32_t nfonts = 0;
+    uint32_t nextra = 0;
+    //INI the style was compiled from, file times are too coarse to tell if it changed
+    uint32_t iniHash = 0;
+    uint64_t iniSize = 0;
+};
+
+static std::string ReadStyleIni(const std::filesystem::path& stylePath)
+{
+    std::ifstream fin(stylePath);
+    if (!fin)
+        throw std::runtime_error("Can't read " + stylePath.string());
+    return std::string((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+}
+
+//ini is null when only the compiled style is available
+static bool IsStyleBinValid(const StyleBinHeader& hdr, const std::string* ini)
+{
+    const StyleBinHeader ref;
+    if (memcmp(hdr.magic, ref.magic, sizeof(hdr.magic)) || hdr.version != ref.version ||
+        hdr.imguiVersion != ref.imguiVersion || hdr.styleSize != ref.styleSize)
+        return false;
+    if (ini && (hdr.iniSize != ini->size() || hdr.iniHash != ImHashData(ini->data(), ini->size())))
+        return false;
+    return true;
+}
+
+static bool ReadStyleBin(const std::string& data, const std::string* ini, ImGuiStyle* style, std::vector<StyleFont>& fonts, std::map<std::string, std::string>* extra)
+{
+    StyleBinHeader hdr;
+    if (data.size() < sizeof(hdr) + sizeof(ImGuiStyle))
+        return false;
+    memcpy(&hdr, data.data(), sizeof(hdr));
+    if (!IsStyleBinValid(hdr, ini))
+        return false;
+    memcpy(style, data.data() + sizeof(hdr), sizeof(ImGuiStyle));
+
+    size_t pos = sizeof(hdr) + sizeof(ImGuiStyle);
+    auto read = [&](void* dst, size_t n) {
+        if (pos + n > data.size())
+            return false;
+        memcpy(dst, data.data() + pos, n);
+        pos += n;
+        return true;
+    };
+    auto readStr = [&](std::string& str) {
+        uint32_t n;
+        if (!read(&n, sizeof(n)) || pos + n > data.size())
+            return false;
+        str.assign(data.data() + pos, n);
+        pos += n;
+        return true;
+    };
+    fonts.resize(hdr.nfonts);
+    for (auto& font : fonts)
+    {
+        uint8_t hasRange;
+        if (!readStr(font.key) || !readStr(font.fname) ||
+            !read(&font.size, sizeof(font.size)) ||
+            !read(&font.goffset, sizeof(font.goffset)) ||
+            !read(&hasRange, sizeof(hasRange)) ||
+            !read(font.range, sizeof(font.range)))
+            return false;
+        font.hasRange = hasRange;
+    }
+    for (uint32_t i = 0; i < hdr.nextra; ++i)
+    {
+        std::string key, value;
+        if (!readStr(key) || !readStr(value))
+            return false;
+        if (extra)
+            (*extra)[key] = std::move(value);
+    }
+    return true;
+}
+
+static std::string CompiledStylePath(const std::string& spath)
+{
+    return u8string(u8path(spath).replace_extension(".stylebin"));
+}
 
-                ImFontConfig cfg;
-                snprintf(cfg.Name, sizeof(cfg.Name), "%s", key.c_str());
-                cfg.MergeMode = key == lastFont;
-                cfg.GlyphRanges = hasRange ? rngs.back().get() : nullptr;
-                cfg.GlyphOffset = { goffset.x * fontScaling, goffset.y * fontScaling };
-                ImFont* font;
+bool IsStyleCompiled(const std::string& spath)
+{
+    std::ifstream bin(u8path(CompiledStylePath(spath)), std::ios::binary);
+    StyleBinHeader hdr;
+    if (!bin.read((char*)&hdr, sizeof(hdr)))
+        return false;
+    std::string ini = ReadStyleIni(u8path(spath));
+    return IsStyleBinValid(hdr, &ini);
+}
+
+void CompileStyle(const std::string& spath)
+{
+    auto stylePath = u8path(spath);
+    std::string ini = ReadStyleIni(stylePath);
+    std::istringstream fin(ini);
+    ImGuiStyle style;
+    std::vector<StyleFont> fonts;
+    std::map<std::string, std::string> extra;
+    ParseStyleIni(fin, &style, fonts, &extra);
+
+    std::string binPath = CompiledStylePath(spath);
+    std::ofstream fout(u8path(binPath), std::ios::binary);
+    if (!fout)
+        throw std::runtime_error("can't write '" + binPath + "'");
+    auto write = [&](const void* src, size_t n) {
+        fout.write((const char*)src, n);
+    };
+    auto writeStr = [&](const std::string& str) {
+        uint32_t n = (uint32_t)str.size();
+        write(&n, sizeof(n));
+        write(str.data(), n);
+    };
+    StyleBinHeader hdr;
+    hdr.nfonts = (uint32_t)fonts.size();
+    hdr.nextra = (uint32_t)extra.size();
+    hdr.iniHash = ImHashData(ini.data(), ini.size());
+    hdr.iniSize = ini.size();
+    write(&hdr, sizeof(hdr));
+    write(&style, sizeof(style));
+    for (const auto& font : fonts)
+    {
+        uint8_t hasRange = font.hasRange;
+        writeStr(font.key);
+        writeStr(font.fname);
+        write(&font.size, sizeof(font.size));
+        write(&font.goffset, sizeof(font.goffset));
+        write(&hasRange, sizeof(hasRange));
+        write(font.range, sizeof(font.range));
+    }
+    for (const auto& ex : extra)
+    {
+        writeStr(ex.first);
+        writeStr(ex.second);
+    }
+    if (!fout)
+        throw std::runtime_error("can't write '" + binPath + "'");
+}
+
+static void LoadStyleFonts(const std::filesystem::path& stylePath, float fontScaling, const std::vector<StyleFont>& fonts, std::map<std::string, ImFont*>* fontMap)
+{
+    auto& io = ImGui::GetIO();
+    static std::vector<std::unique_ptr<ImWchar[]>> rngs;
+    std::string lastFont;
+    for (const auto& sf : fonts)
+    {
+        const std::string& key = sf.key;
+        const std::string& fname = sf.fname;
+        float size = sf.size;
+        ImFontConfig cfg;
+        snprintf(cfg.Name, sizeof(cfg.Name), "%s", key.c_str());
+        cfg.MergeMode = key == lastFont;
+        if (sf.hasRange) {
+            //needs to outlive this function
+            rngs.push_back(std::unique_ptr<ImWchar[]>(new ImWchar[3]));
+            rngs.back()[0] = sf.range[0];
+            rngs.back()[1] = sf.range[1];
+            rngs.back()[2] = 0;
+        }
+        cfg.GlyphRanges = sf.hasRange ? rngs.back().get() : nullptr;
+        cfg.GlyphOffset = { sf.goffset.x * fontScaling, sf.goffset.y * fontScaling };
+        ImFont* font;
 #ifdef ANDROID
-                auto font_data = GetAndroidAsset(fname.c_str());
-                font = io.Fonts->AddFontFromMemoryTTF(font_data.first, font_data.second, size * fontScaling, &cfg);
+        auto font_data = GetAndroidAsset(fname.c_str());
+        font = io.Fonts->AddFontFromMemoryTTF(font_data.first, font_data.second, size * fontScaling, &cfg);
 #else
 #ifdef IMRAD_WITH_MINIZIP
-                if (!fname.compare(0, 4, "zip:"))
-                {
-                    auto fpath = u8path(fname.substr(4));
-                    if (fpath.is_relative())
-                        fpath = stylePath.parent_path() / fpath;
-                    auto buffer = UnzipAssetData("zip:" + u8string(fpath));
-                    if (buffer.empty())
-                        throw std::runtime_error("Can't read '" + u8string(fname) + "'");
-                    font = io.Fonts->AddFontFromMemoryTTF(buffer.data(), (int)buffer.size(), size * fontScaling, &cfg);
-                }
-                else
+        if (!fname.compare(0, 4, "zip:"))
+        {
+            auto fpath = u8path(fname.substr(4));
+            if (fpath.is_relative())
+                fpath = stylePath.parent_path() / fpath;
+            auto buffer = UnzipAssetData("zip:" + u8string(fpath));
+            if (buffer.empty())
+                throw std::runtime_error("Can't read '" + u8string(fname) + "'");
+            font = io.Fonts->AddFontFromMemoryTTF(buffer.data(), (int)buffer.size(), size * fontScaling, &cfg);
+        }
+        else
 #endif
-                {
-                    auto fpath = u8path(fname);
-                    if (fpath.is_relative())
-                        fpath = stylePath.parent_path() / fpath;
-                    if (!std::ifstream(fpath))
-                        throw std::runtime_error("Can't read '" + u8string(fpath) + "'");
-                    font = io.Fonts->AddFontFromFileTTF(u8string(fpath).c_str(), size * fontScaling, &cfg);
-                }
+        {
+            auto fpath = u8path(fname);
+            if (fpath.is_relative())
+                fpath = stylePath.parent_path() / fpath;
+            font = AddFontFromFileCached(u8string(fpath), size * fontScaling, &cfg);
+            if (!font)
+                throw std::runtime_error("Can't read '" + u8string(fpath) + "'");
+        }
 #endif
-                if (!font)
-                    throw std::runtime_error("Can't load " + fname);
-                if (!cfg.MergeMode && fontMap)
-                    (*fontMap)[lastFont == "" ? "" : key] = font;
+        if (!font)
+            throw std::runtime_error("Can't load " + fname);
+        if (!cfg.MergeMode && fontMap)
+            (*fontMap)[lastFont == "" ? "" : key] = font;
 
-                lastFont = key;
-            }
-            else if (extra)
-            {
-                (*extra)[cat + "." + key] = is.str();
-            }
-        }
+        lastFont = key;
     }
     if (fontMap && !(*fontMap).count(""))
         (*fontMap)[""] = io.Fonts->AddFontDefault();
 }
 
+void LoadStyle(const std::string& spath, float fontScaling, ImGuiStyle* dst, std::map<std::string, ImFont*>* fontMap, std::map<std::string, std::string>* extra)
+{
+    ImGuiStyle* style = dst ? dst : &ImGui::GetStyle();
+    *style = ImGuiStyle();
+    std::vector<StyleFont> fonts;
+
+    //compiled style is preferred when it was built from the same INI content
+    //by the same ImGui. INI is only read and hashed which is much cheaper than parsing it
+    auto stylePath = u8path(spath);
+    auto binPath = u8path(CompiledStylePath(spath));
+    std::error_code err;
+    bool hasIni = std::filesystem::exists(stylePath, err);
+    std::string ini = hasIni ? ReadStyleIni(stylePath) : "";
+    bool loaded = false;
+    if (std::filesystem::exists(binPath, err))
+    {
+        std::ifstream bin(binPath, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(bin)), std::istreambuf_iterator<char>());
+        std::map<std::string, std::string> tmpExtra;
+        loaded = ReadStyleBin(data, hasIni ? &ini : nullptr, style, fonts, &tmpExtra);
+        if (loaded && extra)
+            extra->insert(tmpExtra.begin(), tmpExtra.end());
+        if (!loaded) {
+            *style = ImGuiStyle();
+            fonts.clear();
+        }
+    }
+    if (!loaded)
+    {
+        if (!hasIni)
+            throw std::runtime_error("Can't read " + stylePath.string());
+        std::istringstream fin(ini);
+        ParseStyleIni(fin, style, fonts, extra);
+    }
+
+    LoadStyleFonts(stylePath, fontScaling, fonts, fontMap);
+}
+
 ImFont* GetFontByName(const char* name)
 {
     if (!*name)
@@ -1751,8 +2225,340 @@ ImFont* GetFontByName(const std::string& name)
     return GetFontByName(name.c_str());
 }
 
+//GNU .mo catalog. Strings in .mo are NUL terminated so results point
+//directly into the mapped file
+class MoCatalog
+{
+public:
+    ~MoCatalog() { Close(); }
+
+    bool Open(const std::string& path)
+    {
+        Close();
+#if defined(ANDROID)
+        auto asset = GetAndroidAsset(path.c_str());
+        if (!asset.first)
+            return false;
+        buffer.assign((const char*)asset.first, (const char*)asset.first + asset.second);
+        data = buffer.data();
+        size = buffer.size();
+#elif defined(_WIN32)
+        std::ifstream fin(std::filesystem::u8path(path), std::ios::binary);
+        if (!fin)
+            return false;
+        buffer.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+#else
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) || !st.st_size) {
+            close(fd);
+            return false;
+        }
+        void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED)
+            return false;
+        data = (const char*)ptr;
+        size = st.st_size;
+        mapped = true;
+#endif
+        if (!Parse()) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Close()
+    {
+#if !defined(_WIN32) && !defined(ANDROID)
+        if (mapped)
+            munmap((void*)data, size);
+        mapped = false;
+#endif
+        buffer.clear();
+        buffer.shrink_to_fit();
+        data = nullptr;
+        size = 0;
+        messages.clear();
+        pluralExpr = "n != 1";
+    }
+
+    //returns NUL separated plural forms, null view when not found
+    //lookup is by content and doesn't allocate for usual context lengths
+    std::string_view Find(const char* context, const char* msgid) const
+    {
+        std::string_view key = msgid;
+        char buf[256];
+        std::string tmp;
+        if (context) {
+            size_t clen = std::strlen(context);
+            size_t len = clen + 1 + key.size();
+            char* dst = buf;
+            if (len > sizeof(buf)) {
+                tmp.resize(len);
+                dst = tmp.data();
+            }
+            std::memcpy(dst, context, clen);
+            dst[clen] = '\x04';
+            std::memcpy(dst + clen + 1, msgid, key.size());
+            key = std::string_view(dst, len);
+        }
+        auto it = messages.find(key);
+        return it != messages.end() ? it->second : std::string_view();
+    }
+
+    //returns selected form or nullptr when the catalog has less forms
+    const char* PluralForm(std::string_view forms, int n) const
+    {
+        PluralEval ev{ pluralExpr.c_str(), (unsigned long)std::abs(n) };
+        size_t pos = 0;
+        for (unsigned long idx = ev.Ternary(); idx; --idx) {
+            pos = forms.find('\0', pos);
+            if (pos == std::string_view::npos)
+                return nullptr;
+            ++pos;
+        }
+        return forms.data() + pos;
+    }
+
+private:
+    //evaluates C-like Plural-Forms expression
+    struct PluralEval
+    {
+        const char* p;
+        unsigned long n;
+
+        bool Is(const char* op)
+        {
+            while (*p == ' ' || *p == '\t' || *p == '\n')
+                ++p;
+            size_t len = std::strlen(op);
+            if (std::strncmp(p, op, len))
+                return false;
+            //don't consume prefix of a different operator
+            if (len == 1 && (*op == '<' || *op == '>' || *op == '!') && p[1] == '=')
+                return false;
+            p += len;
+            return true;
+        }
+        unsigned long Ternary()
+        {
+            unsigned long c = Or();
+            if (!Is("?"))
+                return c;
+            unsigned long a = Ternary();
+            Is(":");
+            unsigned long b = Ternary();
+            return c ? a : b;
+        }
+        unsigned long Or()
+        {
+            unsigned long v = And();
+            while (Is("||")) {
+                unsigned long r = And();
+                v = v || r;
+            }
+            return v;
+        }
+        unsigned long And()
+        {
+            unsigned long v = Equality();
+            while (Is("&&")) {
+                unsigned long r = Equality();
+                v = v && r;
+            }
+            return v;
+        }
+        unsigned long Equality()
+        {
+            unsigned long v = Relation();
+            while (true) {
+                if (Is("=="))
+                    v = v == Relation();
+                else if (Is("!="))
+                    v = v != Relation();
+                else
+                    return v;
+            }
+        }
+        unsigned long Relation()
+        {
+            unsigned long v = Additive();
+            while (true) {
+                if (Is("<="))
+                    v = v <= Additive();
+                else if (Is(">="))
+                    v = v >= Additive();
+                else if (Is("<"))
+                    v = v < Additive();
+                else if (Is(">"))
+                    v = v > Additive();
+                else
+                    return v;
+            }
+        }
+        unsigned long Additive()
+        {
+            unsigned long v = Multiplicative();
+            while (true) {
+                if (Is("+"))
+                    v += Multiplicative();
+                else if (Is("-"))
+                    v -= Multiplicative();
+                else
+                    return v;
+            }
+        }
+        unsigned long Multiplicative()
+        {
+            unsigned long v = Unary();
+            while (true) {
+                if (Is("*"))
+                    v *= Unary();
+                else if (Is("/")) {
+                    unsigned long r = Unary();
+                    v = r ? v / r : 0;
+                }
+                else if (Is("%")) {
+                    unsigned long r = Unary();
+                    v = r ? v % r : 0;
+                }
+                else
+                    return v;
+            }
+        }
+        unsigned long Unary()
+        {
+            if (Is("!"))
+                return !Unary();
+            if (Is("(")) {
+                unsigned long v = Ternary();
+                Is(")");
+                return v;
+            }
+            if (Is("n"))
+                return n;
+            unsigned long v = 0;
+            while (*p >= '0' && *p <= '9')
+                v = v * 10 + (*p++ - '0');
+            return v;
+        }
+    };
+
+    uint32_t Read32(size_t off) const
+    {
+        uint32_t v;
+        std::memcpy(&v, data + off, 4);
+        if (swapped)
+            v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+        return v;
+    }
+
+    bool Parse()
+    {
+        if (size < 28)
+            return false;
+        uint32_t magic;
+        std::memcpy(&magic, data, 4);
+        if (magic == 0x950412de)
+            swapped = false;
+        else if (magic == 0xde120495)
+            swapped = true;
+        else
+            return false;
+        uint32_t count = Read32(8);
+        uint32_t origOff = Read32(12);
+        uint32_t transOff = Read32(16);
+        if (origOff > size || transOff > size ||
+            count > (size - origOff) / 8 || count > (size - transOff) / 8)
+            return false;
+        messages.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t olen = Read32(origOff + 8 * i);
+            uint32_t opos = Read32(origOff + 8 * i + 4);
+            uint32_t tlen = Read32(transOff + 8 * i);
+            uint32_t tpos = Read32(transOff + 8 * i + 4);
+            if (opos >= size || olen >= size - opos || data[opos + olen] ||
+                tpos >= size || tlen >= size - tpos || data[tpos + tlen])
+                return false;
+            //plural msgid is stored as "singular\0plural", key is the singular
+            std::string_view key(data + opos);
+            if (key.empty()) {
+                ParseHeader(std::string_view(data + tpos, tlen));
+                continue;
+            }
+            if (tlen)
+                messages.emplace(key, std::string_view(data + tpos, tlen));
+        }
+        return true;
+    }
+
+    void ParseHeader(std::string_view header)
+    {
+        size_t i = header.find("Plural-Forms:");
+        if (i == std::string_view::npos)
+            return;
+        i = header.find("plural=", i);
+        if (i == std::string_view::npos)
+            return;
+        i += 7;
+        size_t j = header.find_first_of(";\n", i);
+        pluralExpr = header.substr(i, j == std::string_view::npos ? j : j - i);
+    }
+
+    const char* data = nullptr;
+    size_t size = 0;
+    bool swapped = false;
+#if !defined(_WIN32) && !defined(ANDROID)
+    bool mapped = false;
+#endif
+    std::vector<char> buffer; //when the file can't be mapped
+    std::unordered_map<std::string_view, std::string_view> messages;
+    std::string pluralExpr = "n != 1";
+};
+
+//catalog is read-only after loading so Translate can be called from any thread
+//as long as LoadTranslation doesn't run at the same time. TrCache overloads write
+//to the call site cache and belong to the thread running Draw
+struct Translation
+{
+    MoCatalog catalog;
+    bool loaded = false;
+    int generation = 0; //invalidates TrCache
+};
+
+static Translation& GetTranslation()
+{
+    static Translation tr;
+    return tr;
+}
+
+bool LoadTranslation(const std::string& moPath)
+{
+    auto& tc = GetTranslation();
+    tc.loaded = false;
+    ++tc.generation;
+    if (moPath == "") {
+        tc.catalog.Close();
+        return true;
+    }
+    tc.loaded = tc.catalog.Open(moPath);
+    return tc.loaded;
+}
+
 const char* Translate(const char* text)
 {
+    auto& tc = GetTranslation();
+    if (tc.loaded) {
+        auto forms = tc.catalog.Find(nullptr, text);
+        return forms.data() ? forms.data() : text;
+    }
 #ifdef IMRAD_WITH_GETTEXT
     return gettext(text);
 #else
@@ -1762,6 +2568,11 @@ const char* Translate(const char* text)
 
 const char* Translate(const char* context, const char* text)
 {
+    auto& tc = GetTranslation();
+    if (tc.loaded) {
+        auto forms = tc.catalog.Find(context, text);
+        return forms.data() ? forms.data() : text;
+    }
 #ifdef IMRAD_WITH_GETTEXT
     return pgettext(context, text);
 #else
@@ -1769,22 +2580,61 @@ const char* Translate(const char* context, const char* text)
 #endif
 }
 
+//without a catalog gettext may change with the locale so only catalog lookups are cached
+const char* Translate(TrCache& cache, const char* text)
+{
+    auto& tc = GetTranslation();
+    if (!tc.loaded)
+        return Translate(text);
+    if (cache.generation != tc.generation) {
+        cache.str = Translate(text);
+        cache.generation = tc.generation;
+    }
+    return cache.str;
+}
+
+const char* Translate(TrCache& cache, const char* context, const char* text)
+{
+    auto& tc = GetTranslation();
+    if (!tc.loaded)
+        return Translate(context, text);
+    if (cache.generation != tc.generation) {
+        cache.str = Translate(context, text);
+        cache.generation = tc.generation;
+    }
+    return cache.str;
+}
+
 const char* Translate(const char* text, const char* plural, int n)
 {
+    auto& tc = GetTranslation();
+    if (tc.loaded) {
+        auto forms = tc.catalog.Find(nullptr, text);
+        const char* str = forms.data() ? tc.catalog.PluralForm(forms, n) : nullptr;
+        if (str)
+            return str;
+    }
 #ifdef IMRAD_WITH_GETTEXT
-    return ngettext(text, plural, n);
-#else
-    return n ? plural : text;
+    else
+        return ngettext(text, plural, n);
 #endif
+    return n == 1 ? text : plural;
 }
 
 const char* Translate(const char* context, const char* text, const char* plural, int n)
 {
+    auto& tc = GetTranslation();
+    if (tc.loaded) {
+        auto forms = tc.catalog.Find(context, text);
+        const char* str = forms.data() ? tc.catalog.PluralForm(forms, n) : nullptr;
+        if (str)
+            return str;
+    }
 #ifdef IMRAD_WITH_GETTEXT
-    return npgettext(context, text, plural, n);
-#else
-    return n ? plural : text;
+    else
+        return npgettext(context, text, plural, n);
 #endif
+    return n == 1 ? text : plural;
 }
 
 } // namespace
@@ -172,8 +172,7 @@ ImDrawList* Table::DoDraw(UIContext& ctx)
     int fl = flags;
     if (stx::count(ctx.selected, this)) //force columns at design time
         fl |= ImGuiTableFlags_BordersInner;
-    std::string name = "table" + std::to_string((uint64_t)this);
-    if (ImGui::BeginTable(name.c_str(), n, fl, size))
+    if (ImGui::BeginTable("table", n, fl, size)) //unique within Widget::Draw PushID
     {
         //need to override drawList because when table is in a Child mode its drawList will be drawn on top
         drawList = ImGui::GetWindowDrawList();
@@ -2192,14 +2191,16 @@ ImDrawList* TabBar::DoDraw(UIContext& ctx)
     if (!style_framePadding.empty())
         ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, style_framePadding.eval_px(ctx));
 
-    std::string id = "##" + std::to_string((uintptr_t)this);
-    //add tab names in order so that when tab order changes in designer we get a
+    //hash tab nodes in order so that when tab order changes in designer we get a
     //different id which will force ImGui to recalculate tab positions and
     //render tabs correctly
+    ImU32 order = 0;
     for (const auto& child : children)
-        id += std::to_string(uintptr_t(child.get()) & 0xffff);
+        HashCombineData(order, child.get());
+    char id[16];
+    snprintf(id, sizeof(id), "##%08X", order);
 
-    if (ImGui::BeginTabBar(id.c_str(), flags))
+    if (ImGui::BeginTabBar(id, flags))
     {
         //CustomSizerAdd
         if (l.flags & Layout::VLayout)
@@ -2565,6 +2566,8 @@ void TabItem::DoDrawTools(UIContext& ctx)
 
     ImGui::BeginDisabled(!idx);
     if (ImGui::Button(ICON_FA_ANGLE_LEFT)) {
+        *ctx.modified = true;
+        MarkEdited();
         auto ptr = std::move(parent->children[idx]);
         parent->children.erase(parent->children.begin() + idx);
         parent->children.insert(parent->children.begin() + idx - 1, std::move(ptr));
@@ -2573,6 +2576,8 @@ void TabItem::DoDrawTools(UIContext& ctx)
 
     ImGui::SameLine();
     if (ImGui::Button(ICON_FA_FOLDER_PLUS)) {
+        *ctx.modified = true;
+        MarkEdited();
         parent->children.insert(parent->children.begin() + idx + 1, std::make_unique<TabItem>(ctx));
         if (ctx.selected.size() == 1 && ctx.selected[0] == this)
             ctx.selected[0] = (parent->children.begin() + idx + 1)->get();
@@ -2581,6 +2586,8 @@ void TabItem::DoDrawTools(UIContext& ctx)
     ImGui::SameLine();
     ImGui::BeginDisabled(idx + 1 == parent->children.size());
     if (ImGui::Button(ICON_FA_ANGLE_RIGHT)) {
+        *ctx.modified = true;
+        MarkEdited();
         auto ptr = std::move(parent->children[idx]);
         parent->children.erase(parent->children.begin() + idx);
         parent->children.insert(parent->children.begin() + idx + 1, std::move(ptr));
@@ -2902,12 +2909,14 @@ ImDrawList* ContextMenu::DoDraw(UIContext& ctx)
         ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding,
             style_rounding.empty() ? ImGui::GetStyle().PopupRounding : style_rounding.eval_px(ctx));
 
-        std::string id = label + "##" + std::to_string((uintptr_t)this);
+        //window names ignore the ID stack
+        char id[32];
+        snprintf(id, sizeof(id), "##ContextMenu%p", (void*)this);
         ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 1);
         bool sel = stx::count(ctx.selected, this);
         if (sel)
             ImGui::PushStyleColor(ImGuiCol_Border, ctx.colors[UIContext::Selected]);
-        ImGui::Begin(id.c_str(), nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoSavedSettings);
+        ImGui::Begin(id, nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoSavedSettings);
         {
             if (sel)
                 ImGui::PopStyleColor();
@@ -3115,9 +3124,10 @@ ImDrawList* MenuIt::DoDraw(UIContext& ctx)
                 pos.y -= pad.y;
             }
             ImGui::SetNextWindowPos(pos);
-            std::string id = label.display_string() + "##" + std::to_string((uintptr_t)this);
+            char id[32];
+            snprintf(id, sizeof(id), "##MenuIt%p", (void*)this);
             ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 1);
-            ImGui::Begin(id.c_str(), nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoSavedSettings);
+            ImGui::Begin(id, nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoSavedSettings);
             {
                 ctx.activePopups.push_back(ImGui::GetCurrentWindow());
                 //for (const auto& child : children) defend against insertions within the loop
@@ -3174,6 +3184,8 @@ void MenuIt::DoDrawTools(UIContext& ctx)
 
     ImGui::BeginDisabled(!idx);
     if (ImGui::Button(vertical ? ICON_FA_ANGLE_UP : ICON_FA_ANGLE_LEFT, bsize)) {
+        *ctx.modified = true;
+        MarkEdited();
         auto ptr = std::move(parent->children[idx]);
         parent->children.erase(parent->children.begin() + idx);
         parent->children.insert(parent->children.begin() + idx - 1, std::move(ptr));
@@ -3182,6 +3194,8 @@ void MenuIt::DoDrawTools(UIContext& ctx)
 
     ImGui::SameLine();
     if (ImGui::Button(vertical ? ICON_FA_PLUS ICON_FA_ANGLE_DOWN : ICON_FA_PLUS ICON_FA_ANGLE_RIGHT, bsize)) {
+        *ctx.modified = true;
+        MarkEdited();
         parent->children.insert(parent->children.begin() + idx + 1, std::make_unique<MenuIt>(ctx));
         if (ctx.selected.size() == 1 && ctx.selected[0] == this)
             ctx.selected[0] = parent->children[idx + 1].get();
@@ -3190,6 +3204,8 @@ void MenuIt::DoDrawTools(UIContext& ctx)
     ImGui::SameLine();
     ImGui::BeginDisabled(children.size());
     if (ImGui::Button(vertical ? ICON_FA_PLUS ICON_FA_ANGLE_RIGHT : ICON_FA_PLUS ICON_FA_ANGLE_DOWN, bsize)) {
+        *ctx.modified = true;
+        MarkEdited();
         children.push_back(std::make_unique<MenuIt>(ctx));
         if (ctx.selected.size() == 1 && ctx.selected[0] == this)
             ctx.selected[0] = children[0].get();
@@ -3199,6 +3215,8 @@ void MenuIt::DoDrawTools(UIContext& ctx)
     ImGui::SameLine();
     ImGui::BeginDisabled(idx + 1 == parent->children.size());
     if (ImGui::Button(vertical ? ICON_FA_ANGLE_DOWN : ICON_FA_ANGLE_RIGHT, bsize)) {
+        *ctx.modified = true;
+        MarkEdited();
         auto ptr = std::move(parent->children[idx]);
         parent->children.erase(parent->children.begin() + idx);
         parent->children.insert(parent->children.begin() + idx + 1, std::move(ptr));
@@ -21,15 +21,18 @@ std::unique_ptr<Widget> DockSpace::Clone(UIContext& ctx)
 
 ImDrawList* DockSpace::DoDraw(UIContext& ctx)
 {
-    ImGuiID dockId = ImGui::GetID(("DockSpace" + std::to_string((uintptr_t)this)).c_str());
+    ImGuiID dockId = ImGui::GetID("DockSpace"); //unique within Widget::Draw PushID
     ImVec2 sz{ size_x.eval_px(ImGuiAxis_X, ctx), size_y.eval_px(ImGuiAxis_Y, ctx) };
     ImVec2 dockSize = ImGui::CalcItemSize(sz, ImGui::GetContentRegionAvail().x, ImGui::GetContentRegionAvail().y);
 
-    ImU32 hash = CalcHash(ctx);
-    if (hash != ctx.prevDockspaceHash || ctx.beingResized)
+    //rebuild only when dock nodes were edited, created or destroyed
+    if (!ImGui::DockBuilderGetNode(dockId) ||
+        builtRevision != DockNode::revision ||
+        builtGeneration != UINode::instanceGeneration)
     {
-        ctx.prevDockspaceHash = hash;
-        //this needs to be run only when nodes change
+        builtRevision = DockNode::revision;
+        builtGeneration = UINode::instanceGeneration;
+        builtSize = dockSize;
         //ImGui::DockBuilderRemoveNode(dockId); not needed
         ImGuiID rootId = ImGui::DockBuilderAddNode(dockId, ImGuiDockNodeFlags_DockSpace);
         ImGui::DockBuilderSetNodeSize(rootId, dockSize);
@@ -42,6 +45,20 @@ ImDrawList* DockSpace::DoDraw(UIContext& ctx)
 
         ImGui::DockBuilderFinish(dockId);
     }
+    else if (dockSize.x != builtSize.x || dockSize.y != builtSize.y)
+    {
+        //keep the tree and apply split ratios to the new size
+        //ImGui would otherwise keep absolute sizes of nodes next to the central node
+        builtSize = dockSize;
+        ImGui::DockBuilderSetNodeSize(dockId, dockSize);
+        ImVec2 avail = dockSize;
+        for (auto& child : children)
+        {
+            auto* node = dynamic_cast<DockNode*>(child.get());
+            if (node)
+                node->ResizeNode(avail, ctx);
+        }
+    }
 
     if (!style_emptyBg.empty())
         ImGui::PushStyleColor(ImGuiCol_DockingEmptyBg, style_emptyBg.eval(ImGuiCol_DockingEmptyBg, ctx));
@@ -60,21 +77,6 @@ ImDrawList* DockSpace::DoDraw(UIContext& ctx)
     return ImGui::GetWindowDrawList();
 }
 
-uint32_t DockSpace::CalcHash(UIContext& ctx)
-{
-    //force hash change when beingResized changes to reflect splitRatios
-    uint32_t hash = ctx.beingResized;
-    HashCombineData(hash, size_x.value());
-    HashCombineData(hash, size_y.value());
-
-    for (const auto& child : children) {
-        auto* node = dynamic_cast<DockNode*>(child.get());
-        if (node)
-            node->CalcHash(hash);
-    }
-    return hash;
-}
-
 void DockSpace::DoDrawTools(UIContext& ctx)
 {
     ImGui::SetNextWindowPos(cached_pos, 0, { 0, 1.f });
@@ -114,23 +116,29 @@ void DockSpace::DoExport(std::ostream& os, UIContext& ctx)
         << size_y.to_arg(ctx.unit, ctx.stretchSizeExpr[1]) << " }, "
         << "ImGui::GetContentRegionAvail().x, ImGui::GetContentRegionAvail().y);\n";
 
-    os << ctx.ind << "if (!ImGui::DockBuilderGetNode(dockId))\n";
-    os << ctx.ind << "{\n";
+    //layout is a constant table applied once by ImRad::ApplyDockLayout
+    //so following frames only pay for the DockBuilderGetNode lookup
+    std::ostringstream layout;
+    int count = 0;
+    bool constant = true;
     ctx.ind_up();
-    os << ctx.ind << "ImGuiID rootId = ImGui::DockBuilderAddNode(dockId, ImGuiDockNodeFlags_DockSpace);\n";
-    os << ctx.ind << "ImGui::DockBuilderSetNodeSize(rootId, dockSize);\n";
-
-    os << ctx.ind << "/// @separator\n\n";
-
-    ctx.parentVarName = "rootId";
     for (const auto& child : children)
-        child->Export(os, ctx);
-
-    os << ctx.ind << "/// @separator\n";
-
-    os << ctx.ind << "ImGui::DockBuilderFinish(dockId);\n";
+    {
+        DockNode* chnode = dynamic_cast<DockNode*>(child.get());
+        if (chnode)
+            chnode->ExportLayout(layout, -1, count, constant, ctx);
+    }
     ctx.ind_down();
-    os << ctx.ind << "}\n\n";
+
+    if (count)
+    {
+        //bound split ratios can't be part of a static table
+        os << ctx.ind << (constant ? "static constexpr" : "const")
+            << " auto dockLayout = ImRad::MakeDockLayout({\n";
+        os << layout.str();
+        os << ctx.ind << "});\n";
+        os << ctx.ind << "ImRad::ApplyDockLayout(dockId, dockSize, dockLayout);\n\n";
+    }
 
     if (!style_preview.empty())
         os << ctx.ind << "ImGui::PushStyleColor(ImGuiCol_DockingPreview, " << style_preview.to_arg() << ");\n";
@@ -159,7 +167,12 @@ void DockSpace::DoExport(std::ostream& os, UIContext& ctx)
 
 void DockSpace::DoImport(const cpp::stmt_iterator& sit, UIContext& ctx)
 {
-    if (sit->kind == cpp::CallExpr && sit->callee == "ImGui::DockSpace")
+    if (sit->kind == cpp::CallExpr && sit->callee == "ImRad::MakeDockLayout")
+    {
+        if (sit->params.size())
+            ImportLayout(sit->params[0], ctx);
+    }
+    else if (sit->kind == cpp::CallExpr && sit->callee == "ImGui::DockSpace")
     {
         if (sit->params.size() >= 3) {
             if (!flags.set_from_arg(sit->params[2]))
@@ -183,6 +196,79 @@ void DockSpace::DoImport(const cpp::stmt_iterator& sit, UIContext& ctx)
     }
 }
 
+//parses {{parent,dir,ratio,flags,"windows"},...} written by DockNode::ExportLayout
+//older files contain DockBuilder calls which are imported through DockNode blocks
+void DockSpace::ImportLayout(const std::string& arg, UIContext& ctx)
+{
+    children.clear();
+    std::vector<DockNode*> nodes;
+    std::vector<std::string> fields;
+    int level = 0;
+    int paren = 0;
+    bool quoted = false;
+    for (size_t i = 0; i < arg.size(); ++i)
+    {
+        char c = arg[i];
+        if (quoted)
+        {
+            fields.back() += c;
+            if (c == '\\' && i + 1 < arg.size())
+                fields.back() += arg[++i];
+            else if (c == '"')
+                quoted = false;
+        }
+        else if (level == 2 && paren)
+        {
+            //inside a bound ratio like std::min(a,b), commas don't separate fields
+            if (c == '(' || c == '[' || c == '{')
+                ++paren;
+            else if (c == ')' || c == ']' || c == '}')
+                --paren;
+            quoted = c == '"';
+            fields.back() += c;
+        }
+        else if (c == '{')
+        {
+            if (++level == 2)
+                fields.assign(1, "");
+        }
+        else if (c == '}')
+        {
+            if (level-- != 2)
+                continue;
+            if (fields.size() != 5) {
+                PushError(ctx, "unrecognized dock layout entry");
+                continue;
+            }
+            auto node = std::make_unique<DockNode>(ctx);
+            node->splitDir.set_from_arg(fields[1]);
+            node->splitRatio.set_from_arg(fields[2]);
+            if (!node->flags.set_from_arg(fields[3]))
+                PushError(ctx, "unrecognized flag in \"" + fields[3] + "\"");
+            const std::string& wins = fields[4];
+            if (wins.size() >= 2 && wins.front() == '"' && wins.back() == '"')
+                node->labels = cpp::unescape(std::string_view(wins).substr(1, wins.size() - 2));
+
+            int parent = std::atoi(fields[0].c_str());
+            auto& dst = parent >= 0 && parent < (int)nodes.size() ?
+                nodes[parent]->children : children;
+            nodes.push_back(node.get());
+            dst.push_back(std::move(node));
+        }
+        else if (level == 2)
+        {
+            if (c == ',')
+                fields.push_back("");
+            else {
+                if (c == '(' || c == '[')
+                    ++paren;
+                quoted = c == '"';
+                fields.back() += c;
+            }
+        }
+    }
+}
+
 std::vector<UINode::Prop>
 DockSpace::Properties()
 {
@@ -262,12 +348,8 @@ ImGuiID DockNode::SplitNode(ImGuiID parentId, UIContext& ctx)
 
     if (children.empty())
     {
-        std::istringstream is(labels=="" ? " " : labels);
-        std::string label;
-        while (std::getline(is, label)) {
-            std::string id = "###" + label + std::to_string((uint64_t)this);
-            ImGui::DockBuilderDockWindow(id.c_str(), nodeId);
-        }
+        for (const auto& name : WindowNames())
+            ImGui::DockBuilderDockWindow(name.c_str(), nodeId);
     }
 
     ImGuiID splitId = nodeId;
@@ -281,6 +363,25 @@ ImGuiID DockNode::SplitNode(ImGuiID parentId, UIContext& ctx)
     return parentId;
 }
 
+//names are rebuilt only when labels change so drawing doesn't format them every frame
+//the ID part after ### is what DockBuilderDockWindow hashes
+const std::vector<std::string>& DockNode::WindowNames()
+{
+    const std::string& src = labels;
+    if (namesOwner == this && namesLabels == src)
+        return windowNames;
+    namesOwner = this;
+    namesLabels = src;
+    windowNames.clear();
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%p", (void*)this);
+    std::istringstream is(src == "" ? " " : src);
+    std::string label;
+    while (std::getline(is, label))
+        windowNames.push_back(label + "###" + label + buf);
+    return windowNames;
+}
+
 void DockNode::CalcSizeEx(ImVec2 p1, UIContext& ctx)
 {
     ImGuiDockNode* node = ImGui::DockBuilderGetNode(nodeId);
@@ -290,17 +391,32 @@ void DockNode::CalcSizeEx(ImVec2 p1, UIContext& ctx)
     }
 }
 
-void DockNode::CalcHash(uint32_t& hash)
+//mirrors SplitNode, avail is the size of the node being split
+//and receives size of the remaining node
+void DockNode::ResizeNode(ImVec2& avail, UIContext& ctx)
 {
-    HashCombineData(hash, (ImGuiDir)splitDir);
-    HashCombineData(hash, splitRatio.value());
-    HashCombineData(hash, (int)flags);
-    HashCombineData(hash, labels.display_string().size());
-
-    for (const auto& child : children) {
-        auto* node = dynamic_cast<DockNode*>(child.get());
-        if (node)
-            node->CalcHash(hash);
+    float ratio = splitRatio.eval(ctx);
+    if (!ratio)
+        ratio = DOCKSPACE_SPLIT_RATIO;
+    ImGuiAxis axis = splitDir == ImGuiDir_Left || splitDir == ImGuiDir_Right ? ImGuiAxis_X : ImGuiAxis_Y;
+    ImVec2 size = avail;
+    size[axis] *= ratio;
+    avail[axis] -= size[axis];
+
+    ImGuiDockNode* node = ImGui::DockBuilderGetNode(nodeId);
+    if (!node)
+        return;
+    ImGui::DockBuilderSetNodeSize(nodeId, size);
+    ImGuiDockNode* parent = node->ParentNode;
+    ImGuiDockNode* rest = parent ? parent->ChildNodes[parent->ChildNodes[0] == node] : nullptr;
+    if (rest)
+        ImGui::DockBuilderSetNodeSize(rest->ID, avail);
+
+    for (const auto& child : children)
+    {
+        DockNode* chnode = dynamic_cast<DockNode*>(child.get());
+        if (chnode)
+            chnode->ResizeNode(size, ctx);
     }
 }
 
@@ -311,13 +427,10 @@ ImDrawList* DockNode::DoDraw(UIContext& ctx)
     if (children.empty())
     {
         ImVec2 tsize = ImGui::CalcTextSize(labels.display_string().c_str());
-        std::istringstream is(labels=="" ? " " : labels);
-        std::string label;
-        while (std::getline(is, label))
+        for (const auto& name : WindowNames())
         {
-            std::string id = label + "###" + label + std::to_string((uint64_t)this);
             //ImGuiWindowFlags_NoSavedSettings can't be used
-            if (ImGui::Begin(id.c_str(), nullptr, ImGuiWindowFlags_NoFocusOnAppearing))
+            if (ImGui::Begin(name.c_str(), nullptr, ImGuiWindowFlags_NoFocusOnAppearing))
             {
                 dl = ImGui::GetWindowDrawList();
 
@@ -376,6 +489,8 @@ void DockNode::DoDrawTools(UIContext& ctx)
         ImGuiDir_Up : ImGuiDir_Left;
     if (ImGui::Button(splitSibling ? "Split Same" : "Split 2x"))
     {
+        *ctx.modified = true;
+        MarkEdited();
         if (!splitSibling) //split in 2
         {
             auto chnode = std::make_unique<DockNode>(ctx);
@@ -407,9 +522,12 @@ void DockNode::DoDrawTools(UIContext& ctx)
     ImGui::BeginDisabled(!parent || !i);
     if (ImGui::Button("Node Up"))
     {
+        *ctx.modified = true;
+        MarkEdited();
         auto self = std::move(parent->children[i]);
         parent->children.erase(parent->children.begin() + i);
         parent->children.insert(parent->children.begin() + i - 1, std::move(self));
+        ++revision;
     }
     ImGui::EndDisabled();
 
@@ -417,29 +535,31 @@ void DockNode::DoDrawTools(UIContext& ctx)
     ImGui::BeginDisabled(!parent || i + 1 == parent->children.size());
     if (ImGui::Button("Node Down"))
     {
+        *ctx.modified = true;
+        MarkEdited();
         auto self = std::move(parent->children[i]);
         parent->children.erase(parent->children.begin() + i);
         parent->children.insert(parent->children.begin() + i + 1, std::move(self));
+        ++revision;
     }
     ImGui::EndDisabled();
 
     ImGui::End();
 }
 
+//nodes are exported by DockSpace as a single layout table, see ExportLayout
 void DockNode::DoExport(std::ostream& os, UIContext& ctx)
 {
-    std::string nodeIdVar = "nodeId" + std::to_string(ctx.varCounter++);
-
-    os << ctx.ind << "ImGuiID " << nodeIdVar << " = ImGui::DockBuilderSplitNode("
-        << ctx.parentVarName << ", " << splitDir.to_arg() << ", " << splitRatio.to_arg()
-        << ", nullptr" << ", &" << ctx.parentVarName << ");\n";
+}
 
-    if (flags)
-    {
-        os << ctx.ind << "ImGui::DockBuilderGetNode(" << nodeIdVar << ")->LocalFlags = "
-            << flags.to_arg() << ";\n";
-    }
+//writes one ImRad::DockLayoutNode row per node in the order SplitNode visits them
+void DockNode::ExportLayout(std::ostream& os, int parent, int& count, bool& constant, UIContext& ctx)
+{
+    int index = count++;
+    if (!splitRatio.empty() && !splitRatio.has_value())
+        constant = false;
 
+    std::string windows;
     if (children.empty())
     {
         if (labels.empty())
@@ -449,24 +569,20 @@ void DockNode::DoExport(std::ostream& os, UIContext& ctx)
         std::string label;
         while (std::getline(is, label))
         {
-            os << ctx.ind << "ImGui::DockBuilderDockWindow(\"" << label
-                << "\", " << nodeIdVar << ");\n";
+            if (windows != "")
+                windows += "\\n";
+            windows += cpp::escape(label);
         }
     }
-    else
-    {
-        std::string tmp = ctx.parentVarName;
-        ctx.parentVarName = nodeIdVar;
-        os << ctx.ind << "/// @separator\n\n";
 
-        for (const auto& child : children)
-        {
-            DockNode* chnode = dynamic_cast<DockNode*>(child.get());
-            if (chnode)
-                chnode->Export(os, ctx);
-        }
+    os << ctx.ind << "{ " << parent << ", " << splitDir.to_arg() << ", "
+        << splitRatio.to_arg() << ", " << flags.to_arg() << ", \"" << windows << "\" },\n";
 
-        ctx.parentVarName = tmp;
+    for (const auto& child : children)
+    {
+        DockNode* chnode = dynamic_cast<DockNode*>(child.get());
+        if (chnode)
+            chnode->ExportLayout(os, index, count, constant, ctx);
     }
 }
 
@@ -591,6 +707,7 @@ bool DockNode::PropertyUI(int i, UIContext& ctx)
            comboDlg.font = nullptr;
            comboDlg.OpenPopup([this](ImRad::ModalResult) {
                *labels.access() = Trim(comboDlg.value);
+               ++revision;
                });
        }
        ImGui::PopFont();
@@ -598,6 +715,8 @@ bool DockNode::PropertyUI(int i, UIContext& ctx)
        break;
     }
     }
+    if (changed)
+        ++revision;
     return changed;
 }
 
@@ -7,8 +7,12 @@ struct DockSpace : Widget
     bindable<color_t> style_preview;
     bindable<color_t> style_emptyBg;
 
+    //DockBuilder layout is rebuilt when these differ from current values
+    int builtRevision = -1;
+    unsigned builtGeneration = 0;
+    ImVec2 builtSize;
+
     DockSpace(UIContext& ctx);
-    uint32_t CalcHash(UIContext& ctx);
     auto Clone(UIContext& ctx)->std::unique_ptr<Widget>;
     int Behavior() { return SnapSides | NoOverlayPos | HasSizeX | HasSizeY; }
     ImDrawList* DoDraw(UIContext& ctx);
@@ -17,6 +21,7 @@ struct DockSpace : Widget
     bool PropertyUI(int i, UIContext& ctx);
     void DoExport(std::ostream& os, UIContext& ctx);
     void DoImport(const cpp::stmt_iterator& sit, UIContext& ctx);
+    void ImportLayout(const std::string& arg, UIContext& ctx);
     const char* GetIcon() const { return ICON_FA_TABLE; }
     const DockSpace& Defaults() { static DockSpace var(UIContext::Defaults()); return var; }
 };
@@ -28,12 +33,19 @@ struct DockNode : Widget
     bindable<float> splitRatio = 0;
     direct_val<std::string> labels = "";
     ImGuiID nodeId = 0;
+    //bumped by property edits and tool actions of any dock node
+    static inline int revision = 0;
+    //cached by WindowNames, owner check keeps copies from sharing names
+    const void* namesOwner = nullptr;
+    std::string namesLabels;
+    std::vector<std::string> windowNames;
 
     DockNode(UIContext& ctx);
-    void CalcHash(uint32_t& hash);
     auto Clone(UIContext& ctx)->std::unique_ptr<Widget>;
     int Behavior() { return NoOverlayPos; }
     ImGuiID SplitNode(ImGuiID parentId, UIContext& ctx);
+    void ResizeNode(ImVec2& avail, UIContext& ctx);
+    const std::vector<std::string>& WindowNames();
     ImDrawList* DoDraw(UIContext& ctx);
     void CalcSizeEx(ImVec2 p1, UIContext& ctx);
     void DoDrawTools(UIContext& ctx);
@@ -42,6 +54,7 @@ struct DockNode : Widget
     auto Events()->std::vector<Prop>;
     void DoExport(std::ostream& os, UIContext& ctx);
     void DoImport(const cpp::stmt_iterator& sit, UIContext& ctx);
+    void ExportLayout(std::ostream& os, int parent, int& count, bool& constant, UIContext& ctx);
     void ExportHelp(std::ostream& os, UIContext& ctx);
     const char* GetIcon() const { return "N"; }
     const DockNode& Defaults() { static DockNode var(UIContext::Defaults()); return var; }
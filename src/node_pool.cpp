@@ -0,0 +1,76 @@
+#include "node_pool.h"
+#include <new>
+
+void* NodeArena::Upstream::do_allocate(size_t bytes, size_t align)
+{
+    reserved += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+}
+
+void NodeArena::Upstream::do_deallocate(void* p, size_t bytes, size_t align)
+{
+    reserved -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+}
+
+NodeArena::NodeArena()
+    : pool(&upstream)
+{
+}
+
+NodeArena* NodeArena::Create()
+{
+    return new NodeArena;
+}
+
+NodeArena& NodeArena::Default()
+{
+    //never destroyed so nodes released during static destruction are safe
+    static NodeArena* arena = new NodeArena;
+    return *arena;
+}
+
+void NodeArena::Release()
+{
+    if (current == this)
+        current = nullptr;
+    Unref();
+}
+
+void NodeArena::Unref()
+{
+    if (!--refs)
+        delete this; //pool destructor returns all blocks
+}
+
+NodeArena* NodeArena::Current()
+{
+    return current ? current : &Default();
+}
+
+void NodeArena::SetCurrent(NodeArena* arena)
+{
+    current = arena;
+}
+
+//each node is preceded by a header pointing to its arena
+void* NodeArena::Allocate(size_t size)
+{
+    NodeArena* arena = Current();
+    char* ptr = static_cast<char*>(arena->pool.allocate(size + HEADER, HEADER));
+    *reinterpret_cast<NodeArena**>(ptr) = arena;
+    ++arena->refs;
+    arena->used += size;
+    return ptr + HEADER;
+}
+
+void NodeArena::Deallocate(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+    char* block = static_cast<char*>(ptr) - HEADER;
+    NodeArena* arena = *reinterpret_cast<NodeArena**>(block);
+    arena->used -= size;
+    arena->pool.deallocate(block, size + HEADER, HEADER);
+    arena->Unref();
+}
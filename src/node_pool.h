@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+
+//Per document memory for UINode objects.
+//Each open file owns an arena, nodes created while it is current (import, new
+//widgets, Clone) are carved out of its pool so they don't call the general heap
+//for every widget. Closing the file drops the document reference and the whole
+//pool is released at once after the last node allocated from it is destroyed
+//(clipboard copies may outlive the file). Nodes remember their arena so they can
+//be destroyed while another arena is current.
+//Nodes are only created and destroyed on the UI thread so no locking is done
+class NodeArena
+{
+public:
+    static const size_t HEADER = alignof(std::max_align_t); //keeps node alignment
+
+    //new arena with one reference held by the document
+    static NodeArena* Create();
+    //drops the document reference
+    void Release();
+
+    //arena used for new nodes, Default() when nullptr is set
+    static NodeArena* Current();
+    static void SetCurrent(NodeArena* arena);
+    //never destroyed, used when no file is active and for static nodes
+    static NodeArena& Default();
+
+    static void* Allocate(size_t size);
+    static void Deallocate(void* ptr, size_t size);
+
+    //memory taken from the heap and memory in use by live nodes
+    size_t Reserved() const { return upstream.reserved; }
+    size_t Used() const { return used; }
+
+    //makes arena current for the lifetime of the scope
+    struct Scope
+    {
+        Scope(NodeArena* arena) : prev(current) { SetCurrent(arena); }
+        ~Scope() { current = prev; }
+        NodeArena* prev;
+    };
+
+private:
+    //counts what the pool takes from the heap
+    struct Upstream : std::pmr::memory_resource
+    {
+        size_t reserved = 0;
+        void* do_allocate(size_t bytes, size_t align) override;
+        void do_deallocate(void* p, size_t bytes, size_t align) override;
+        bool do_is_equal(const std::pmr::memory_resource& r) const noexcept override { return this == &r; }
+    };
+
+    NodeArena();
+    NodeArena(const NodeArena&) = delete;
+    void Unref();
+
+    static inline NodeArena* current = nullptr;
+    Upstream upstream;
+    std::pmr::unsynchronized_pool_resource pool;
+    size_t refs = 1;
+    size_t used = 0;
+};
@@ -10,9 +10,11 @@
 #include "ui_input_name.h"
 #include "ui_select_resource.h"
 #include <misc/cpp/imgui_stdlib.h>
-#include <nfd.h>
 #include <algorithm>
 #include <array>
+#include <map>
+#include <unordered_map>
+#include <typeindex>
 
 const std::string TMP_RECT_VAR = "tmpRect";
 const std::string TMP_LAST_ITEM_VAR = "tmpLastItem";
@@ -672,6 +674,89 @@ UINode::FindChild(const UINode* ch)
     return {};
 }
 
+void UINode::TreeRowUI(const TreeRow& row, UIContext& ctx)
+{
+    //TopWindow indents its children by ItemSpacing, the rest by FontSize
+    float indent = row.depth ? ImGui::GetStyle().ItemSpacing.x + (row.depth - 1) * ImGui::GetFontSize() : 0;
+    if (indent)
+        ImGui::Indent(indent);
+    bool selected = stx::count(ctx.selected, row.node) || ctx.snapParent == row.node;
+    bool toggleKey = ImGui::IsKeyDown(ImGuiKey_LeftCtrl) || ImGui::IsKeyDown(ImGuiKey_RightCtrl);
+
+    if (row.kind == TreeRow::Window)
+    {
+        if (selected)
+            ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyle().Colors[ImGuiCol_ButtonHovered]);
+        ImGui::SetNextItemOpen(true, ImGuiCond_Always);
+        ImGui::TreeNodeEx(row.label.c_str(), ImGuiTreeNodeFlags_SpanAllColumns | ImGuiTreeNodeFlags_NoTreePushOnOpen);
+        if (selected)
+            ImGui::PopStyleColor();
+        if (ImGui::IsItemClicked() && !toggleKey) //don't participate in group selection
+            ctx.selected = { row.node };
+        ImGui::SameLine(0, 0);
+        ImGui::TextDisabled(" : %s", row.suffix.c_str());
+    }
+    else if (row.kind == TreeRow::Node)
+    {
+        //align icon
+        float sp = ImGui::GetFontSize() * 1.4f - ImGui::CalcTextSize(row.icon.c_str(), 0, true).x;
+        ImGui::Dummy({ sp, 0 });
+        ImGui::SameLine(0, 0);
+
+        ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyle().Colors[ImGuiCol_TextDisabled]);
+        ImGui::SetNextItemOpen(true, ImGuiCond_Always);
+        //we keep all items open, OpenOnDoubleClick is to block flickering
+        int flags = ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        if (row.leaf)
+            flags |= ImGuiTreeNodeFlags_Leaf;
+        ImGui::TreeNodeEx(row.icon.c_str(), flags);
+        if (ImGui::IsItemClicked())
+        {
+            if (toggleKey)
+                toggle(ctx.selected, row.node);
+            else
+                ctx.selected = { row.node };
+        }
+        ImGui::PopStyleColor();
+        ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyle().Colors[selected ? ImGuiCol_ButtonHovered : ImGuiCol_Text]);
+        ImGui::SameLine();
+        if (row.label != "") {
+            ImGui::Text("\"");
+            ImGui::SameLine(0, 0);
+            float avail = ImGui::GetContentRegionAvail().x -
+                ImGui::CalcTextSize(("\"" + row.suffix).c_str()).x -
+                ImGui::GetStyle().ItemSpacing.x; //emulate WindowPadding which is set to 0
+            if (row.suffix.size())
+                avail -= ImGui::GetStyle().ItemSpacing.x;
+            ImGui::PushFont(!row.ascii ? ctx.defaultStyleFont : ImGui::GetFont());
+            ImGui::TextAligned(0, avail, "%s", row.label.c_str());
+            ImGui::PopFont();
+            ImGui::SameLine(0, 0);
+            ImGui::Text("\"");
+        }
+        else {
+            ImGui::Text("%s", row.typeName.c_str());
+        }
+        ImGui::PopStyleColor();
+        ImGui::SameLine();
+        ImGui::TextDisabled("%s", row.suffix.c_str());
+    }
+    else
+    {
+        ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyle().Colors[ImGuiCol_TextDisabled]);
+        //we keep all items open, OpenOnDoubleClick is to block flickering
+        int flags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        ImGui::SetNextItemOpen(true);
+        ImGui::TreeNodeEx(row.icon.c_str(), flags);
+        ImGui::SameLine();
+        ImGui::Text("%s", row.label.c_str());
+        ImGui::PopStyleColor();
+    }
+
+    if (indent)
+        ImGui::Unindent(indent);
+}
+
 std::vector<UINode*>
 UINode::FindInRect(const ImRad::Rect& r)
 {
@@ -770,100 +855,113 @@ void UINode::ResetLayout()
         ch->ResetLayout();
 }
 
+const UINode::PropTable& UINode::GetPropTable()
+{
+    static std::map<std::pair<std::type_index, int>, PropTable> tables;
+    auto key = std::pair{ std::type_index(typeid(*this)), Behavior() };
+    auto it = tables.find(key);
+    if (it != tables.end())
+        return it->second;
+
+    PropTable tab;
+    for (int i = 0; i < 2; ++i)
+    {
+        auto props = i ? Events() : Properties();
+        auto& entries = i ? tab.events : tab.props;
+        entries.reserve(props.size());
+        for (const auto& p : props) {
+            if (!p.property)
+                continue;
+            entries.push_back({ (const char*)p.property - (const char*)this, p.kbdInput });
+        }
+    }
+    return tables.emplace(key, std::move(tab)).first->second;
+}
+
 std::vector<std::string> UINode::UsedFieldVars()
 {
     std::vector<std::string> used;
-    auto props = Properties();
-    for (auto& p : props) {
-        if (!p.property)
-            continue;
-        auto us = p.property->used_variables();
-        used.insert(used.end(), us.begin(), us.end());
-    }
-    for (auto& child : children) {
-        auto us = child->UsedFieldVars();
-        used.insert(used.end(), us.begin(), us.end());
-    }
+    DoUsedFieldVars(used);
     stx::sort(used);
     used.erase(stx::unique(used), used.end());
     return used;
 }
 
+void UINode::DoUsedFieldVars(std::vector<std::string>& used)
+{
+    for (const auto& e : GetPropTable().props) {
+        auto us = PropAt(e)->used_variables();
+        used.insert(used.end(), us.begin(), us.end());
+    }
+    for (auto& child : children)
+        child->DoUsedFieldVars(used);
+}
+
 void UINode::RenameFieldVars(std::string_view oldn, std::string_view newn, const property_base* exclusion)
 {
     std::string oldns(oldn), newns(newn);
-    for (int i = 0; i < 2; ++i)
-    {
-        auto props = i ? Events() : Properties();
-        for (auto& p : props) {
-            if (!p.property || p.property == exclusion)
+    DoRenameFieldVars(oldns, newns, exclusion);
+}
+
+void UINode::DoRenameFieldVars(const std::string& oldn, const std::string& newn, const property_base* exclusion)
+{
+    const auto& tab = GetPropTable();
+    for (const auto* entries : { &tab.props, &tab.events }) {
+        for (const auto& e : *entries) {
+            property_base* prop = PropAt(e);
+            if (prop == exclusion)
                 continue;
-            p.property->rename_variable(oldns, newns);
+            prop->rename_variable(oldn, newn);
         }
     }
     for (auto& child : children)
-        child->RenameFieldVars(oldn, newn);
+        child->DoRenameFieldVars(oldn, newn, nullptr);
 }
 
 //----------------------------------------------------
 
+template <class T>
+std::unique_ptr<Widget> CreateWidget(UIContext& ctx)
+{
+    return std::make_unique<T>(ctx);
+}
+
 std::unique_ptr<Widget>
 Widget::Create(const std::string& name, UIContext& ctx)
 {
-    if (name == "Text")
-        return std::make_unique<Text>(ctx);
-    else if (name == "Selectable")
-        return std::make_unique<Selectable>(ctx);
-    else if (name == "Button")
-        return std::make_unique<Button>(ctx);
-    else if (name == "CheckBox")
-        return std::make_unique<CheckBox>(ctx);
-    else if (name == "RadioButton")
-        return std::make_unique<RadioButton>(ctx);
-    else if (name == "Input")
-        return std::make_unique<Input>(ctx);
-    else if (name == "Combo")
-        return std::make_unique<Combo>(ctx);
-    else if (name == "Slider")
-        return std::make_unique<Slider>(ctx);
-    else if (name == "ProgressBar")
-        return std::make_unique<ProgressBar>(ctx);
-    else if (name == "ColorEdit")
-        return std::make_unique<ColorEdit>(ctx);
-    else if (name == "Image")
-        return std::make_unique<Image>(ctx);
-    else if (name == "Spacer")
-        return std::make_unique<Spacer>(ctx);
-    else if (name == "Separator")
-        return std::make_unique<Separator>(ctx);
-    else if (name == "CustomWidget")
-        return std::make_unique<CustomWidget>(ctx);
-    else if (name == "Table")
-        return std::make_unique<Table>(ctx);
-    else if (name == "Child")
-        return std::make_unique<Child>(ctx);
-    else if (name == "CollapsingHeader")
-        return std::make_unique<CollapsingHeader>(ctx);
-    else if (name == "TabBar")
-        return std::make_unique<TabBar>(ctx);
-    else if (name == "TabItem")
-        return std::make_unique<TabItem>(ctx);
-    else if (name == "TreeNode")
-        return std::make_unique<TreeNode>(ctx);
-    else if (name == "MenuBar")
-        return std::make_unique<MenuBar>(ctx);
-    else if (name == "ContextMenu")
-        return std::make_unique<ContextMenu>(ctx);
-    else if (name == "MenuIt")
-        return std::make_unique<MenuIt>(ctx);
-    else if (name == "Splitter")
-        return std::make_unique<Splitter>(ctx);
-    else if (name == "DockSpace")
-        return std::make_unique<DockSpace>(ctx);
-    else if (name == "DockNode")
-        return std::make_unique<DockNode>(ctx);
-    else
+    using Factory = std::unique_ptr<Widget>(*)(UIContext&);
+    static const std::unordered_map<std::string_view, Factory> registry{
+        { "Text", &CreateWidget<Text> },
+        { "Selectable", &CreateWidget<Selectable> },
+        { "Button", &CreateWidget<Button> },
+        { "CheckBox", &CreateWidget<CheckBox> },
+        { "RadioButton", &CreateWidget<RadioButton> },
+        { "Input", &CreateWidget<Input> },
+        { "Combo", &CreateWidget<Combo> },
+        { "Slider", &CreateWidget<Slider> },
+        { "ProgressBar", &CreateWidget<ProgressBar> },
+        { "ColorEdit", &CreateWidget<ColorEdit> },
+        { "Image", &CreateWidget<Image> },
+        { "Spacer", &CreateWidget<Spacer> },
+        { "Separator", &CreateWidget<Separator> },
+        { "CustomWidget", &CreateWidget<CustomWidget> },
+        { "Table", &CreateWidget<Table> },
+        { "Child", &CreateWidget<Child> },
+        { "CollapsingHeader", &CreateWidget<CollapsingHeader> },
+        { "TabBar", &CreateWidget<TabBar> },
+        { "TabItem", &CreateWidget<TabItem> },
+        { "TreeNode", &CreateWidget<TreeNode> },
+        { "MenuBar", &CreateWidget<MenuBar> },
+        { "ContextMenu", &CreateWidget<ContextMenu> },
+        { "MenuIt", &CreateWidget<MenuIt> },
+        { "Splitter", &CreateWidget<Splitter> },
+        { "DockSpace", &CreateWidget<DockSpace> },
+        { "DockNode", &CreateWidget<DockNode> },
+    };
+    auto it = registry.find(name);
+    if (it == registry.end())
         return {};
+    return it->second(ctx);
 }
 
 float Widget::GetScaledMinWidth(UIContext& ctx)
@@ -1386,6 +1484,7 @@ void Widget::Draw(UIContext& ctx)
         {
             ImVec2 delta = ImGui::GetMouseDragDelta();
             *ctx.modified = true;
+            MarkEdited();
             pos_x = pos_x.value() + delta.x / ImRad::GetUserData().dpiScale;
             pos_y = pos_y.value() + delta.y / ImRad::GetUserData().dpiScale;
             ImGui::ResetMouseDragDelta();
@@ -1412,6 +1511,7 @@ void Widget::Draw(UIContext& ctx)
         if (ImGui::IsMouseDragging(ImGuiMouseButton_Left))
         {
             *ctx.modified = true;
+            MarkEdited();
             ImVec2 delta = ImGui::GetMouseDragDelta() / ImRad::GetUserData().dpiScale;
             ImVec2 sp = ImGui::GetStyle().ItemSpacing;
             const float threshold = 5 * ImGui::GetStyle().FontScaleDpi;
@@ -2051,7 +2151,8 @@ void Widget::Import(cpp::stmt_iterator& sit, UIContext& ctx)
     ctx.importState = 1;
     ctx.importLevel = -1;
     ctx.parents.push_back(this);
-    userCodeBefore = ctx.userCode;
+    userCodeBefore = std::move(ctx.userCode); //user code can be large, don't copy
+    ctx.userCode.clear();
     spacing = -1;
     int ignoreLevel = -1;
 
@@ -2112,7 +2213,8 @@ void Widget::Import(cpp::stmt_iterator& sit, UIContext& ctx)
             }
             else { //separator at end
                 if (!children.empty())
-                    children.back()->userCodeAfter = ctx.userCode;
+                    children.back()->userCodeAfter = std::move(ctx.userCode);
+                ctx.userCode.clear();
                 ctx.importState = 1;
                 sit.enable_parsing(true);
             }
@@ -2972,123 +3074,61 @@ bool Widget::EventUI(int i, UIContext& ctx)
     return changed;
 }
 
-void Widget::TreeUI(UIContext& ctx)
+void Widget::TreeRows(std::vector<TreeRow>& rows, int depth, UIContext& ctx)
 {
-    std::string label, typeLabel;
-    const auto props = Properties();
-    for (const auto& p : props) {
-        if (p.kbdInput && p.property->display_string() != "") {
-            label = PrepareString(p.property->display_string()).label;
-            for (size_t i = 0; i < label.size(); ++i)
-                if (label[i] == '\n') {
-                    label[i] = ' ';
+    TreeRow& row = rows.emplace_back();
+    row.kind = TreeRow::Node;
+    row.node = this;
+    row.depth = depth;
+    row.leaf = children.empty();
+    for (const auto& e : GetPropTable().props) {
+        if (e.kbdInput && PropAt(e)->display_string() != "") {
+            row.label = PrepareString(PropAt(e)->display_string()).label;
+            for (size_t i = 0; i < row.label.size(); ++i)
+                if (row.label[i] == '\n') {
+                    row.label[i] = ' ';
                 }
         }
     }
-    if (label.empty())
-        typeLabel = GetTypeName();
-    std::string icon = ICON_FA_BARS;
+    if (row.label.empty())
+        row.typeName = GetTypeName();
+    row.ascii = IsAscii(row.label);
+    row.icon = ICON_FA_BARS;
     if (GetIcon()) {
-        icon = GetIcon();
+        row.icon = GetIcon();
     }
-    icon += "##" + std::to_string((unsigned long long)this);
-    std::string suff;
+    row.icon += "##" + std::to_string((unsigned long long)this);
     if (hasPos)
-        suff += "P";
+        row.suffix += "P";
     else {
         if (sameLine)
-            suff += "L";
+            row.suffix += "L";
         if (nextColumn)
-            suff += "C";
+            row.suffix += "C";
     }
 
-    bool selected = stx::count(ctx.selected, this) || ctx.snapParent == this;
-    //align icon
-    float sp = ImGui::GetFontSize() * 1.4f - ImGui::CalcTextSize(icon.c_str(), 0, true).x;
-    ImGui::Dummy({ sp, 0 });
-    ImGui::SameLine(0, 0);
-
-    ctx.parents.push_back(this);
-
-    ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyle().Colors[ImGuiCol_TextDisabled]);
-    ImGui::SetNextItemOpen(true, ImGuiCond_Always);
-    //we keep all items open, OpenOnDoubleClick is to block flickering
-    int flags = ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_OpenOnDoubleClick;
-    if (children.empty())
-        flags |= ImGuiTreeNodeFlags_Leaf;
-    if (ImGui::TreeNodeEx(icon.c_str(), flags))
+    if (!itemCount.empty())
     {
-        if (ImGui::IsItemClicked())
-        {
-            if (ImGui::IsKeyDown(ImGuiKey_LeftCtrl) || ImGui::IsKeyDown(ImGuiKey_RightCtrl))
-                toggle(ctx.selected, this);
-            else
-                ctx.selected = { this };
-        }
-        ImGui::PopStyleColor();
-        ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyle().Colors[selected ? ImGuiCol_ButtonHovered : ImGuiCol_Text]);
-        ImGui::SameLine();
-        if (label != "") {
-            ImGui::Text("\"");
-            ImGui::SameLine(0, 0);
-            float avail = ImGui::GetContentRegionAvail().x -
-                ImGui::CalcTextSize(("\"" + suff).c_str()).x -
-                ImGui::GetStyle().ItemSpacing.x; //emulate WindowPadding which is set to 0
-            if (suff.size())
-                avail -= ImGui::GetStyle().ItemSpacing.x;
-            ImGui::PushFont(!IsAscii(label) ? ctx.defaultStyleFont : ImGui::GetFont());
-            ImGui::TextAligned(0, avail, "%s", label.c_str());
-            ImGui::PopFont();
-            ImGui::SameLine(0, 0);
-            ImGui::Text("\"");
-        }
-        else {
-            ImGui::Text("%s", typeLabel.c_str());
-        }
-        ImGui::PopStyleColor();
-        ImGui::SameLine();
-        ImGui::TextDisabled("%s", suff.c_str());
-
-        if (!itemCount.empty())
-        {
-            std::string icon = ICON_FA_RETWEET; // SHARE_NODES;
-            icon += "##IC" + std::to_string((unsigned long long)this);
-            //encourage to use $index, $item not the actual var name
-            std::string label;// = itemCount.index_name_or(ctx.codeGen->FOR_VAR_NAME);
-            //label += "$index=0.." + itemCount.limit.to_arg() + "";
-            label = "$item, $index";
-            bool selected = ctx.mode == UIContext::SnapInsert && ctx.snapParent == this;
-            ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyle().Colors[ImGuiCol_TextDisabled]);
-            //we keep all items open, OpenOnDoubleClick is to block flickering
-            int flags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_OpenOnDoubleClick;
-            ImGui::SetNextItemOpen(true);
-            if (ImGui::TreeNodeEx(icon.c_str(), flags))
-            {
-                ImGui::SameLine();
-                ImGui::Text("%s", label.c_str());
-                ImGui::PopStyleColor();
-                for (auto& child : child_iterator(children, false))
-                    child->TreeUI(ctx);
-                ImGui::TreePop();
-            }
-            else {
-                ImGui::PopStyleColor();
-            }
-            for (auto& child : child_iterator(children, true))
-                child->TreeUI(ctx);
-        }
-        else
-        {
-            for (auto& child : children)
-                child->TreeUI(ctx);
-        }
-        ImGui::TreePop();
+        TreeRow& icRow = rows.emplace_back();
+        icRow.kind = TreeRow::ItemCount;
+        icRow.node = this;
+        icRow.depth = depth + 1;
+        icRow.leaf = true;
+        icRow.ascii = true;
+        icRow.icon = ICON_FA_RETWEET; // SHARE_NODES;
+        icRow.icon += "##IC" + std::to_string((unsigned long long)this);
+        //encourage to use $index, $item not the actual var name
+        icRow.label = "$item, $index";
+        for (auto& child : child_iterator(children, false))
+            child->TreeRows(rows, depth + 2, ctx);
+        for (auto& child : child_iterator(children, true))
+            child->TreeRows(rows, depth + 1, ctx);
     }
-    else {
-        ImGui::PopStyleColor();
+    else
+    {
+        for (auto& child : children)
+            child->TreeRows(rows, depth + 1, ctx);
     }
-
-    ctx.parents.pop_back();
 }
 
 //----------------------------------------------------
@@ -5809,7 +5849,7 @@ ImDrawList* Combo::DoDraw(UIContext& ctx)
         ImGui::SetNextItemWidth(w);
     std::string id = label;
     if (id.empty())
-        id = std::string("##") + std::to_string((uint64_t)&value);
+        id = "##combo"; //unique within Widget::Draw PushID
 
     std::string tmp;
     if (ctx.beingResized)
@@ -5833,7 +5873,7 @@ void Combo::DoExport(std::ostream& os, UIContext& ctx)
 {
     std::string id = label.to_arg();
     if (label.empty())
-        id = std::string("\"##") + std::to_string((uint64_t)&value) + "\"";
+        id = "\"##" + *value.access() + "\"";
 
     if (!size_x.empty())
         os << ctx.ind << "ImGui::SetNextItemWidth(" << size_x.to_arg(ctx.unit, ctx.stretchSizeExpr[0]) << ");\n";
@@ -5845,7 +5885,10 @@ void Combo::DoExport(std::ostream& os, UIContext& ctx)
             os << "if (";
 
         os << "ImRad::Combo(" << id << ", &" << value.to_arg()
-            << ", " << items.to_arg() << ", " << flags.to_arg() << ")";
+            << ", " << items.to_arg() << ", " << flags.to_arg();
+        if (!searchIndex.empty())
+            os << ", &" << searchIndex.to_arg();
+        os << ")";
 
         if (!onChange.empty()) {
             os << ")\n";
@@ -5899,6 +5942,10 @@ void Combo::DoImport(const cpp::stmt_iterator& sit, UIContext& ctx)
                 PushError(ctx, "unrecognized flag in \"" + sit->params[3] + "\"");
         }
 
+        if (sit->params.size() >= 5 && !sit->params[4].compare(0, 1, "&")) {
+            searchIndex.set_from_arg(sit->params[4].substr(1));
+        }
+
         if (sit->kind == cpp::IfCallThenCall)
             onChange.set_from_arg(sit->callee2);
     }
@@ -5953,6 +6000,7 @@ Combo::Properties()
         { "behavior.label", &label, true },
         { "behavior.items##1", &items },
         { "bindings.value##1", &value },
+        { "bindings.searchIndex##1", &searchIndex },
         });
     return props;
 }
@@ -6046,8 +6094,16 @@ bool Combo::PropertyUI(int i, UIContext& ctx)
         ImGui::SameLine(0, 0);
         changed |= BindingButton("value", &value, "std::string", BindingButton_ReferenceOnly, ctx);
         break;
+    case 12:
+        ImGui::BeginDisabled(!onDrawItems.empty());
+        ImGui::Text("searchIndex");
+        ImGui::TableNextColumn();
+        ImGui::SetNextItemWidth(-ImGui::GetFrameHeight());
+        changed = InputFieldRef(&searchIndex, "ImRad::ComboIndex", true, ctx);
+        ImGui::EndDisabled();
+        break;
     default:
-        return Widget::PropertyUI(i - 12, ctx);
+        return Widget::PropertyUI(i - 13, ctx);
     }
     return changed;
 }
@@ -6137,7 +6193,7 @@ ImDrawList* Slider::DoDraw(UIContext& ctx)
     const char* fmt = sfmt.empty() ? nullptr : sfmt.c_str();
     std::string id = label;
     if (label.empty())
-        id = "##" + std::to_string((uint64_t)&value);
+        id = "##slider"; //unique within Widget::Draw PushID
     std::string tid = type.get_id();
     int fl = flags | ImGuiSliderFlags_NoInput;
 
@@ -6907,6 +6963,7 @@ std::unique_ptr<Widget> Image::Clone(UIContext& ctx)
 
 ImDrawList* Image::DoDraw(UIContext& ctx)
 {
+    ImRad::Texture tex = GetTexture();
     float w = GetScaledMinWidth(ctx);
     float h = GetScaledMinWidth(ctx);
     if (!size_x.zero())
@@ -6986,11 +7043,14 @@ void Image::DoExport(std::ostream& os, UIContext& ctx)
 
     ImVec2 uv0(0, 0);
     ImVec2 uv1(1, 1);
-    if (stretchPolicy != Scale && tex.id && size_x.has_value() && size_y.has_value())
+    //size comes from the file header, texture may not be uploaded yet
+    int tw = tex ? tex->w : 0;
+    int th = tex ? tex->h : 0;
+    if (stretchPolicy != Scale && tw && th && size_x.has_value() && size_y.has_value())
     {
         //todo: binded dimensions
-        float wrel = size_x.zero() ? 1.f : size_x.eval_px(ImGuiAxis_X, ctx) / tex.w;
-        float hrel = size_y.zero() ? 1.f : size_y.eval_px(ImGuiAxis_Y, ctx) / tex.h;
+        float wrel = size_x.zero() ? 1.f : size_x.eval_px(ImGuiAxis_X, ctx) / tw;
+        float hrel = size_y.zero() ? 1.f : size_y.eval_px(ImGuiAxis_Y, ctx) / th;
         float scale = 1.f;
         if (stretchPolicy == FitIn)
             scale = std::min(wrel, hrel);
@@ -7110,7 +7170,12 @@ bool Image::PropertyUI(int i, UIContext& ctx)
             });
         if (ImGui::IsItemHovered(ImGuiHoveredFlags_ForTooltip)) {
             ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, { 8, 8 });
-            if (absoluteFileName.size())
+            ImRad::Texture t = GetTexture();
+            if (absoluteFileName.size() && t)
+                ImGui::SetTooltip("Located in \"%s\"\n%d x %d\nTextures in use: %d (%.1f MB)",
+                    absoluteFileName.c_str(), t.w, t.h,
+                    textureCache.TextureCount(), textureCache.MemoryUsage() / (1024.f * 1024.f));
+            else if (absoluteFileName.size())
                 ImGui::SetTooltip("Located in \"%s\"", absoluteFileName.c_str());
             else
                 ImGui::SetTooltip("Can't find \"%s\"", fileName.display_string().c_str());
@@ -7183,17 +7248,14 @@ bool Image::PickFileName(UIContext& ctx)
         return false;
     }
 
-    nfdchar_t *outPath = NULL;
-    nfdfilteritem_t filterItem[2] = {
+    std::string path;
+    if (!OpenFileDialog(path, {
         { "All Images (*.bmp; *.gif; *.jpg; *.png; *.tga)", "bmp,gif,jpg,jpeg,png,tga" },
         { "Resource Files (*.res; *.zip)", "res,zip" },
-    };
-    nfdresult_t result = NFD_OpenDialog(&outPath, filterItem, std::size(filterItem), nullptr);
-    if (result != NFD_OKAY)
+        }))
         return false;
 
-    auto outp = u8path(outPath);
-    NFD_FreePath(outPath);
+    auto outp = u8path(path);
     outp = fs::relative(outp, u8path(ctx.workingDir));
     fs::path rpath = outp.relative_path(); //without C:/
     outp.clear();
@@ -7232,7 +7294,7 @@ bool Image::PickFileName(UIContext& ctx)
 
 void Image::RefreshTexture(UIContext& ctx)
 {
-    tex.id = 0;
+    tex.reset();
     absoluteFileName = "";
 
     if (fileName.empty() ||
@@ -7257,8 +7319,10 @@ void Image::RefreshTexture(UIContext& ctx)
     else
         absoluteFileName = fname;
 
-    tex = ImRad::LoadTextureFromFile(absoluteFileName);
-    if (!tex && ctx.importState)
+    //decoded asynchronously, only report missing files here
+    tex = textureCache.Get(absoluteFileName, fname);
+    std::error_code err;
+    if (!fs::is_regular_file(u8path(fname), err) && ctx.importState)
         PushError(ctx, "can't locate \"" + fileName.display_string() + "\"");
 }
 
@@ -7283,8 +7347,7 @@ ImDrawList* CustomWidget::DoDraw(UIContext& ctx)
     if (!size.y)
         size.y = GetScaledMinWidth(ctx);
 
-    std::string id = std::to_string((uintptr_t)this);
-    if (ImGui::BeginChild(id.c_str(), size, ImGuiChildFlags_Borders))
+    if (ImGui::BeginChild("custom", size, ImGuiChildFlags_Borders)) //unique within Widget::Draw PushID
     {
         ImDrawList* dl = ImGui::GetWindowDrawList();
         auto clr = ImGui::GetStyleColorVec4(ImGuiCol_Border);
@@ -7,6 +7,8 @@
 #include "uicontext.h"
 #include "binding_property.h"
 #include "imrad.h"
+#include "texture_cache.h"
+#include "node_pool.h"
 
 extern const float DEFAULT_ITEM_WIDTH;
 extern const float DEFAULT_MIN_WIDTH;
@@ -41,6 +43,30 @@ struct UINode
         property_base* property;
         bool kbdInput = false; //this property accepts keyboard input by default
     };
+    //hierarchy panel row
+    //rows are flattened so the panel can draw only the visible ones
+    struct TreeRow {
+        enum Kind { Window, Node, ItemCount };
+        Kind kind;
+        UINode* node;
+        int depth;
+        bool leaf;
+        bool ascii; //label can be drawn with UI font
+        std::string icon;
+        std::string label;
+        std::string typeName; //shown when label is empty
+        std::string suffix;
+    };
+    //Properties/Events depend only on the node type and Behavior() so their
+    //layout can be computed once per type and walked without allocations
+    struct PropTable {
+        struct Entry {
+            ptrdiff_t offset; //from UINode*
+            bool kbdInput;
+        };
+        std::vector<Entry> props;
+        std::vector<Entry> events;
+    };
     enum SnapOptions {
         SnapSides = 0x1,
         SnapInterior = 0x2,
@@ -54,12 +80,30 @@ struct UINode
         CustomSizerAdd = 0x2000,
     };
 
-    UINode() {}
-    UINode(const UINode&) {} //shallow copy
-    virtual ~UINode() {}
+    //changes whenever a node is created or destroyed
+    static inline unsigned instanceGeneration = 0;
+    //changes whenever the model is edited, bumped by MarkEdited
+    static inline unsigned editGeneration = 0;
+    //changes whenever existing nodes are moved into or out of a tree (cut, paste, reparent)
+    static inline unsigned treeGeneration = 0;
+    //every edit of node state or tree structure outside of node construction must call this
+    //so caches keyed on the generations (property grid, hierarchy, DrawCache) get rebuilt
+    static void MarkEdited(bool structure = false)
+    {
+        ++editGeneration;
+        if (structure)
+            ++treeGeneration;
+    }
+
+    UINode() { ++instanceGeneration; }
+    UINode(const UINode&) { ++instanceGeneration; } //shallow copy
+    virtual ~UINode() { ++instanceGeneration; }
+    //nodes are allocated from the current NodeArena
+    static void* operator new(size_t size) { return NodeArena::Allocate(size); }
+    static void operator delete(void* ptr, size_t size) { NodeArena::Deallocate(ptr, size); }
     virtual void Draw(UIContext& ctx) = 0;
     virtual void DrawTools(UIContext& ctx) = 0;
-    virtual void TreeUI(UIContext& ctx) = 0;
+    virtual void TreeRows(std::vector<TreeRow>& rows, int depth, UIContext& ctx) = 0;
     virtual auto Properties()->std::vector<Prop> = 0;
     virtual auto Events()->std::vector<Prop> = 0;
     virtual bool PropertyUI(int, UIContext& ctx) = 0;
@@ -72,9 +116,12 @@ struct UINode
 
     void DrawInteriorRect(UIContext& ctx);
     void DrawSnap(UIContext& ctx);
+    auto GetPropTable() -> const PropTable&;
+    auto PropAt(const PropTable::Entry& e) -> property_base* { return (property_base*)((char*)this + e.offset); }
     auto UsedFieldVars() -> std::vector<std::string>;
     void RenameFieldVars(std::string_view oldn, std::string_view newn, const property_base* exclusion = {});
     auto FindChild(const UINode*) -> std::optional<std::pair<UINode*, int>>;
+    static void TreeRowUI(const TreeRow& row, UIContext& ctx);
     auto FindInRect(const ImRad::Rect& r) -> std::vector<UINode*>;
     auto GetAllChildren() -> std::vector<UINode*>;
     void CloneChildrenFrom(const UINode& node, UIContext& ctx);
@@ -82,6 +129,8 @@ struct UINode
     virtual auto GetTypeName()->std::string;
     auto GetLayoutPrefix(UIContext& ctx)->std::string;
     void PushError(UIContext& ctx, const std::string& err);
+    void DoUsedFieldVars(std::vector<std::string>& used);
+    void DoRenameFieldVars(const std::string& oldn, const std::string& newn, const property_base* exclusion);
 
     struct child_iterator;
 
@@ -204,7 +253,7 @@ struct Widget : UINode
     auto Properties() -> std::vector<Prop>;
     auto Events() -> std::vector<Prop>;
     bool PropertyUI(int i, UIContext& ctx);
-    void TreeUI(UIContext& ctx);
+    void TreeRows(std::vector<TreeRow>& rows, int depth, UIContext& ctx);
     bool EventUI(int, UIContext& ctx);
     int Behavior();
     int ColumnCount(UIContext& ctx) { return 0; }
@@ -420,6 +469,7 @@ struct Combo : Widget
     bindable<> value; //don't use bindable<string> that would force format style edit
     bindable<std::vector<std::string>> items;
     direct_val<ImGuiComboFlags_> flags;
+    field_ref<ImRad::ComboIndex> searchIndex; //enables clipped search for large lists
     event<> onChange;
     event<> onDrawItems;
 
@@ -515,7 +565,7 @@ struct Image : Widget
     direct_val<pzdimension_t> style_imageBorderSize;
     direct_val<pzdimension_t> style_imageRounding;
     std::string absoluteFileName;
-    ImRad::Texture tex;
+    std::shared_ptr<const TextureCache::Entry> tex;
 
     Image(UIContext& ctx);
     auto Clone(UIContext& ctx)->std::unique_ptr<Widget>;
@@ -531,6 +581,7 @@ struct Image : Widget
     const char* GetIcon() { return ICON_FA_IMAGE; }
     const Image& Defaults() { static Image var(UIContext::Defaults()); return var; }
     std::string FindPath(const std::string& url, UIContext& ctx, std::string* rname = nullptr);
+    ImRad::Texture GetTexture() const { return tex ? tex->tex : ImRad::Texture(); }
 };
 
 struct CustomWidget : Widget
@@ -60,23 +60,42 @@ std::unique_ptr<TopWindow> TopWindow::Clone(UIContext& ctx)
     return clone;
 }
 
+//caption is rebuilt only when title changes so drawing doesn't format it every frame
+//the ID part after ### keeps it from clashing with other open files
+const std::string& TopWindow::Caption()
+{
+    const std::string& src = *title.access();
+    if (captionOwner == this && captionTitle == src)
+        return caption;
+    captionOwner = this;
+    captionTitle = src;
+    char capId[32];
+    snprintf(capId, sizeof(capId), "###TopWindow%p", (void*)this);
+    caption = title.display_string();
+    caption += capId;
+    return caption;
+}
+
 void TopWindow::Draw(UIContext& ctx)
 {
     ctx.unit = ctx.unit == "px" ? "" : ctx.unit;
     ctx.root = this;
     ctx.isAutoSize = flags & ImGuiWindowFlags_AlwaysAutoResize;
     ctx.prevLayoutHash = ctx.layoutHash;
-    ctx.layoutHash = ctx.isAutoSize;
+    bool replay = ctx.drawCache.Replaying();
     bool dimAll = ctx.activePopups.size(); //from last frame
-    ctx.activePopups.clear();
+    if (!replay) //otherwise keep last frame results
+    {
+        ctx.layoutHash = ctx.isAutoSize;
+        ctx.activePopups.clear();
+        ctx.hovered = nullptr;
+        ctx.contextMenus.clear();
+    }
     ctx.parents = { this };
-    ctx.hovered = nullptr;
     ctx.snapParent = nullptr;
     ctx.kind = kind;
-    ctx.contextMenus.clear();
 
-    std::string cap = title.display_string();
-    cap += "###TopWindow" + std::to_string((size_t)this); //don't clash
+    const std::string& cap = Caption();
     int fl = ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoBringToFrontOnFocus | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoDocking | ImGuiWindowFlags_NoSavedSettings;
     if (ctx.mode != UIContext::NormalSelection)
         fl |= ImGuiWindowFlags_NoResize; //so that window resizing doesn't interfere with snap
@@ -148,7 +167,7 @@ void TopWindow::Draw(UIContext& ctx)
     if (style_titlePadding.has_value())
         ImGui::PopStyleVar();
 
-    ctx.rootWin = ImGui::FindWindowByName(cap.c_str());
+    ctx.rootWin = ImGui::GetCurrentWindow();
     assert(ctx.rootWin);
     for (int i = 0; i < 4; ++i)
     {
@@ -173,21 +192,29 @@ void TopWindow::Draw(UIContext& ctx)
     else if (placement == Bottom && !gap.y)
         ImRad::RenderFilledWindowCorners(ImDrawFlags_RoundCornersBottom);
 
-    ImGui::GetCurrentContext()->NavHighlightItemUnderNav = true;
-    ImGui::GetCurrentContext()->NavCursorVisible = false;
-    if (dimAll)
-        ImGui::PushStyleVar(ImGuiStyleVar_Alpha, 0.2f);
-
-    for (size_t i = 0; i < children.size(); ++i)
-        children[i]->Draw(ctx);
-
-    if (dimAll)
-        ImGui::PopStyleVar();
-    ImGui::GetCurrentContext()->NavCursorVisible = true;
-    ImGui::GetCurrentContext()->NavHighlightItemUnderNav = false;
-
-    for (size_t i = 0; i < children.size(); ++i)
-        children[i]->DrawTools(ctx);
+    if (replay)
+    {
+        ctx.drawCache.Replay(ctx.rootWin);
+    }
+    else
+    {
+        ctx.drawCache.BeginCapture(ctx.rootWin);
+        ImGui::GetCurrentContext()->NavHighlightItemUnderNav = true;
+        ImGui::GetCurrentContext()->NavCursorVisible = false;
+        if (dimAll)
+            ImGui::PushStyleVar(ImGuiStyleVar_Alpha, 0.2f);
+
+        for (size_t i = 0; i < children.size(); ++i)
+            children[i]->Draw(ctx);
+
+        if (dimAll)
+            ImGui::PopStyleVar();
+        ImGui::GetCurrentContext()->NavCursorVisible = true;
+        ImGui::GetCurrentContext()->NavHighlightItemUnderNav = false;
+
+        for (size_t i = 0; i < children.size(); ++i)
+            children[i]->DrawTools(ctx);
+    }
 
     //use all client area to allow snapping close to the border
     auto pad = ImGui::GetStyle().WindowPadding - ImVec2(3+1, 3);
@@ -285,6 +312,25 @@ void TopWindow::Draw(UIContext& ctx)
         dl->PopClipRect();
     }
 
+    if (!replay)
+    {
+        const ImGuiContext& g = *ImGui::GetCurrentContext();
+        bool cacheable = ctx.mode == UIContext::NormalSelection &&
+            !ctx.beingResized &&
+            ctx.activePopups.empty() &&
+            ctx.layoutHash == ctx.prevLayoutHash &&
+            !ctx.rootWin->HiddenFramesCannotSkipItems &&
+            !g.ActiveId &&
+            (!g.HoveredWindow || g.HoveredWindow->RootWindow != ctx.rootWin || !g.HoveredId) && //tooltip delays
+            //child windows aren't submitted during replay, don't lose focus from them
+            (!g.NavWindow || g.NavWindow == ctx.rootWin || g.NavWindow->RootWindow != ctx.rootWin);
+        ctx.drawCache.EndCapture(ctx.rootWin, cacheable);
+    }
+    else
+    {
+        ctx.drawCache.EndReplay(ctx.rootWin);
+    }
+
     ImGui::End();
 
     if (!style_bg.empty())
@@ -902,8 +948,8 @@ void TopWindow::Import(cpp::stmt_iterator& sit, UIContext& ctx)
         {
             ctx.importState = 1;
             sit.enable_parsing(true);
-            userCodeBefore = ctx.userCode;
-            ctx.userCode = "";
+            userCodeBefore = std::move(ctx.userCode);
+            ctx.userCode.clear();
         }
         else if (sit->kind == cpp::Comment && !sit->line.compare(0, 11, "/// @begin "))
         {
@@ -934,10 +980,10 @@ void TopWindow::Import(cpp::stmt_iterator& sit, UIContext& ctx)
             }
             else { //separator at end
                 if (!children.empty())
-                    children.back()->userCodeAfter = ctx.userCode;
+                    children.back()->userCodeAfter = std::move(ctx.userCode);
                 else
-                    userCodeMid = ctx.userCode;
-                ctx.userCode = "";
+                    userCodeMid = std::move(ctx.userCode);
+                ctx.userCode.clear();
                 ctx.importState = 1;
                 sit.enable_parsing(true);
             }
@@ -1226,7 +1272,8 @@ void TopWindow::Import(cpp::stmt_iterator& sit, UIContext& ctx)
         }
     }
 
-    userCodeAfter = ctx.userCode;
+    userCodeAfter = std::move(ctx.userCode);
+    ctx.userCode.clear();
     ctx.createVars = tmpCreateDeps;
 }
 
@@ -1235,41 +1282,20 @@ bool TopWindow::IsTranslated()
     return title.has_tr();
 }
 
-void TopWindow::TreeUI(UIContext& ctx)
+void TopWindow::TreeRows(std::vector<TreeRow>& rows, int depth, UIContext& ctx)
 {
     static const char* NAMES[]{ "MainWindow", "Window", "Popup", "ModalPopup", "Activity" };
 
-    ctx.parents = { this };
-    std::string str = ctx.codeGen->GetName();
-    bool selected = stx::count(ctx.selected, this) || ctx.snapParent == this;
-    if (selected)
-        ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyle().Colors[ImGuiCol_ButtonHovered]);
-    ImGui::PushStyleVar(ImGuiStyleVar_IndentSpacing, ImGui::GetStyle().ItemSpacing.x);// ImGui::GetFontSize());
-    ImGui::SetNextItemOpen(true, ImGuiCond_Always);
-    bool open = ImGui::TreeNodeEx(str.c_str(), ImGuiTreeNodeFlags_SpanAllColumns);
-    if (selected)
-        ImGui::PopStyleColor();
-    ImGui::PopStyleVar();
-    bool activated = ImGui::IsItemClicked(); //todo || ImGui::IsItemActivated();
-    ImGui::SameLine(0, 0);
-    ImGui::TextDisabled(" : %s", NAMES[kind]);
-    if (open)
-    {
-        if (activated)
-        {
-            if (ImGui::IsKeyDown(ImGuiKey_LeftCtrl) || ImGui::IsKeyDown(ImGuiKey_RightCtrl))
-                ; // don't participate in group selection toggle(ctx.selected, this);
-            else
-                ctx.selected = { this };
-        }
-        ImGui::PushStyleVar(ImGuiStyleVar_IndentSpacing, ImGui::GetFontSize());
-        for (const auto& ch : children)
-            ch->TreeUI(ctx);
-        ImGui::PopStyleVar();
-
-        //todo: PushStyleVar(IndentSpacing
-        ImGui::TreePop();
-    }
+    TreeRow& row = rows.emplace_back();
+    row.kind = TreeRow::Window;
+    row.node = this;
+    row.depth = depth;
+    row.leaf = children.empty();
+    row.ascii = true;
+    row.label = ctx.codeGen->GetName();
+    row.suffix = NAMES[kind];
+    for (const auto& ch : children)
+        ch->TreeRows(rows, depth + 1, ctx);
 }
 
 std::vector<UINode::Prop>
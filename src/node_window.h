@@ -38,12 +38,16 @@ struct TopWindow : UINode
     event<> onWindowAppearing;
 
     std::string userCodeBefore, userCodeAfter, userCodeMid;
+    //cached by Caption, owner check keeps copies from sharing it
+    const void* captionOwner = nullptr;
+    std::string captionTitle, caption;
 
     TopWindow(UIContext& ctx);
     auto Clone(UIContext& ctx) -> std::unique_ptr<TopWindow>;
     void Draw(UIContext& ctx);
+    const std::string& Caption();
     void DrawTools(UIContext& ctx) {}
-    void TreeUI(UIContext& ctx);
+    void TreeRows(std::vector<TreeRow>& rows, int depth, UIContext& ctx);
     bool EventUI(int, UIContext& ctx);
     auto Properties() ->std::vector<Prop>;
     auto Events() ->std::vector<Prop>;
@@ -0,0 +1,137 @@
+#include "texture_cache.h"
+#include "utils.h"
+#include <mutex>
+#include <algorithm>
+#include <cstdint>
+#include <stb_image.h>
+
+#ifdef IMRAD_WITH_MINIZIP
+namespace ImRad {
+std::vector<uint8_t> UnzipAssetData(const std::string& url);
+}
+#endif
+
+TextureCache textureCache;
+
+//shared between the worker and the entry, whichever finishes last frees the pixels
+struct TextureCache::Job
+{
+    std::mutex mutex;
+    bool done = false;
+    unsigned char* pixels = nullptr;
+    int w = 0, h = 0;
+
+    ~Job()
+    {
+        if (pixels)
+            stbi_image_free(pixels);
+    }
+};
+
+static void Decode(std::shared_ptr<TextureCache::Job> job, std::string path)
+{
+    int w = 0, h = 0;
+    unsigned char* pixels;
+#ifdef IMRAD_WITH_MINIZIP
+    if (!path.compare(0, 4, "zip:")) {
+        auto buffer = ImRad::UnzipAssetData(path);
+        pixels = stbi_load_from_memory(buffer.data(), (int)buffer.size(), &w, &h, NULL, 4);
+    }
+    else
+#endif
+    {
+        pixels = stbi_load(path.c_str(), &w, &h, NULL, 4);
+    }
+    std::lock_guard<std::mutex> lock(job->mutex);
+    job->pixels = pixels;
+    job->w = w;
+    job->h = h;
+    job->done = true;
+}
+
+std::shared_ptr<const TextureCache::Entry>
+TextureCache::Get(const std::string& path, const std::string& file)
+{
+    std::error_code err;
+    auto time = fs::last_write_time(u8path(file), err);
+    std::string key = path + "|" + std::to_string(time.time_since_epoch().count());
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        if (auto entry = it->second.lock())
+            return entry;
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->path = path;
+    //image size is needed by export before the texture gets uploaded
+#ifdef IMRAD_WITH_MINIZIP
+    if (!path.compare(0, 4, "zip:")) {
+        auto buffer = ImRad::UnzipAssetData(path);
+        stbi_info_from_memory(buffer.data(), (int)buffer.size(), &entry->w, &entry->h, NULL);
+    }
+    else
+#endif
+    {
+        stbi_info(path.c_str(), &entry->w, &entry->h, NULL);
+    }
+    entry->job = std::make_shared<Job>();
+    entries[key] = entry;
+    //decoding is skipped when the entry was released before the worker got to it
+    worker.Post([job = std::weak_ptr<Job>(entry->job), path] {
+        if (auto sjob = job.lock())
+            Decode(sjob, path);
+        });
+    return entry;
+}
+
+void TextureCache::Stop()
+{
+    worker.Stop();
+}
+
+void TextureCache::Update()
+{
+    for (auto it = entries.begin(); it != entries.end(); )
+    {
+        auto entry = it->second.lock();
+        if (!entry) {
+            it = entries.erase(it);
+            continue;
+        }
+        ++it;
+        auto job = entry->job;
+        if (!job)
+            continue;
+        {
+            //worker doesn't touch the job after setting done
+            std::lock_guard<std::mutex> lock(job->mutex);
+            if (!job->done)
+                continue;
+        }
+        entry->job.reset();
+        if (!job->pixels) {
+            entry->failed = true;
+            continue;
+        }
+        entry->tex.id = UploadTexture(job->pixels, job->w, job->h);
+        entry->tex.w = job->w;
+        entry->tex.h = job->h;
+        uploaded.push_back({ entry, entry->tex });
+        memory += (size_t)job->w * job->h * 4;
+        ++revision;
+    }
+
+    for (size_t i = 0; i < uploaded.size(); )
+    {
+        if (!uploaded[i].first.expired()) {
+            ++i;
+            continue;
+        }
+        const auto& tex = uploaded[i].second;
+        DeleteTexture(tex.id);
+        memory -= (size_t)tex.w * tex.h * 4;
+        uploaded.erase(uploaded.begin() + i);
+        ++revision;
+    }
+    count = (int)uploaded.size();
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include "imrad.h"
+#include "worker.h"
+
+//Textures of Image widgets shared by all open files.
+//Entries are keyed by absolute path and write time and released once the last
+//widget referencing them goes away. Files are decoded one by one on a worker thread,
+//GL upload and deletion happen in Update on the UI thread
+class TextureCache
+{
+public:
+    struct Job;
+    struct Entry
+    {
+        ImRad::Texture tex; //id stays 0 until uploaded
+        int w = 0, h = 0; //read from the file header in Get so it's known before upload
+        bool failed = false;
+        std::string path;
+
+    private:
+        friend class TextureCache;
+        std::shared_ptr<Job> job;
+    };
+
+    //file is the file on disk whose write time invalidates the entry
+    //it differs from path for zip: urls
+    std::shared_ptr<const Entry> Get(const std::string& path, const std::string& file);
+    //uploads decoded images and frees unused textures, call once per frame
+    void Update();
+    //drops pending decodes and joins the worker thread
+    void Stop();
+    //changes whenever any texture was uploaded or released
+    int Revision() const { return revision; }
+    size_t MemoryUsage() const { return memory; }
+    int TextureCount() const { return count; }
+
+private:
+    std::map<std::string, std::weak_ptr<Entry>> entries;
+    std::vector<std::pair<std::weak_ptr<Entry>, ImRad::Texture>> uploaded;
+    int revision = 0;
+    size_t memory = 0;
+    int count = 0;
+    Worker worker;
+};
+
+extern TextureCache textureCache;
@@ -55,32 +55,10 @@ void ClassWizard::Refresh()
             used.push_back(var.name);
     }
     else {
-        for (auto root : roots)
-            FindUsed(root, used);
-        stx::sort(used);
-        used.erase(stx::unique(used), used.end());
+        used = varUsage->UsedVars(roots);
     }
 }
 
-void ClassWizard::FindUsed(UINode* node, std::vector<std::string>& used)
-{
-    for (int i = 0; i < 2; ++i)
-    {
-        const auto& props = i ? node->Events() : node->Properties();
-        for (const auto& p : props) {
-            if (!p.property)
-                continue;
-            auto vars = p.property->used_variables();
-            for (const auto& var : vars) {
-                assert(var.find_first_of("[.") == std::string::npos);
-                used.push_back(var);
-            }
-        }
-    }
-    for (const auto& child : node->children)
-        FindUsed(child.get(), used);
-}
-
 void ClassWizard::Draw()
 {
     const float BWIDTH = 150;
@@ -128,6 +106,7 @@ void ClassWizard::Draw()
             newFieldPopup.varOldName = stypes[stypeIdx];
             newFieldPopup.OpenPopup([this] {
                 *modified = true;
+                UINode::MarkEdited();
                 stypes[stypeIdx] = newFieldPopup.varName; //Refresh will keep the selection
                 Refresh();
                 });
@@ -142,6 +121,7 @@ void ClassWizard::Draw()
             newFieldPopup.mode = NewFieldPopup::NewStruct;
             newFieldPopup.OpenPopup([this] {
                 *modified = true;
+                UINode::MarkEdited();
                 stypes.push_back(newFieldPopup.varName);
                 stypeIdx = stypes.size() - 1; //Refresh will keep selection
                 Refresh();
@@ -184,7 +164,7 @@ void ClassWizard::Draw()
                 //ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg0, IM_COL32(255, 255, 255, 255));
                 //ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, IM_COL32(192, 192, 192, 255));
 
-                bool unused = !stx::count(used, var.name);
+                bool unused = !std::binary_search(used.begin(), used.end(), var.name);
                 if (unused)
                     ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled)); // 0xff400040);
 
@@ -241,6 +221,7 @@ void ClassWizard::Draw()
             newFieldPopup.varType = "";
             newFieldPopup.OpenPopup([this] {
                 *modified = true;
+                UINode::MarkEdited();
                 Refresh();
                 });
         }
@@ -258,8 +239,8 @@ void ClassWizard::Draw()
             newFieldPopup.varOldName = fields[selRow].name;
             newFieldPopup.OpenPopup([this] {
                 *modified = true;
-                for (auto root : roots)
-                    root->RenameFieldVars(newFieldPopup.varOldName, newFieldPopup.varName);
+                UINode::MarkEdited();
+                varUsage->Rename(roots, newFieldPopup.varOldName, newFieldPopup.varName);
                 Refresh();
                 });
         }
@@ -272,7 +253,7 @@ void ClassWizard::Draw()
         if (ImGui::Button("Remove Field", { BWIDTH, 0 }))
         {
             std::string name = fields[selRow].name;
-            if (!stypeIdx && stx::count(used, name))
+            if (!stypeIdx && std::binary_search(used.begin(), used.end(), name))
             {
                 messageBox.title = "Remove variable";
                 messageBox.icon = MessageBox::Info;
@@ -281,6 +262,7 @@ void ClassWizard::Draw()
                 messageBox.OpenPopup([this,name](ImRad::ModalResult mr) {
                     if (mr == ImRad::Yes) {
                         *modified = true;
+                        UINode::MarkEdited();
                         codeGen->RemoveVar(name);
                         Refresh();
                     }
@@ -289,6 +271,7 @@ void ClassWizard::Draw()
             else
             {
                 *modified = true;
+                UINode::MarkEdited();
                 codeGen->RemoveVar(name, stypeIdx ? stypes[stypeIdx] : "");
                 Refresh();
             }
@@ -309,8 +292,9 @@ void ClassWizard::Draw()
                 if (mr == ImRad::Yes) {
                     for (const auto& fi : fields)
                     {
-                        if (!stx::count(used, fi.name)) {
+                        if (!std::binary_search(used.begin(), used.end(), fi.name)) {
                             *modified = true;
+                            UINode::MarkEdited();
                             codeGen->RemoveVar(fi.name);
                         }
                     }
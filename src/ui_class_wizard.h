@@ -17,10 +17,10 @@ public:
     CppGen* codeGen;
     std::vector<UINode*> roots;
     bool* modified;
+    VarUsageIndex* varUsage;
 
 private:
     void Refresh();
-    void FindUsed(UINode* node, std::vector<std::string>& used);
 
     std::string varName;
     std::string className;
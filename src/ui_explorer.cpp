@@ -4,8 +4,15 @@
 #include "stx.h"
 #include "imrad.h"
 #include "cppgen.h"
+#include "worker.h"
 #include <sstream>
+#include <iomanip>
 #include <chrono>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <iterator>
+#include <unordered_map>
 #include <IconsFontAwesome6.h>
 #include <imgui_internal.h>
 
@@ -19,18 +26,50 @@ struct ExplorerEntry
     std::string modified;
 };
 
+//directory listing runs on a worker thread so slow folders don't block the UI
+//jobs are shared with the worker, superseded jobs are cancelled
+struct ListingJob
+{
+    std::atomic<bool> cancel{ false };
+    bool progressive; //show entries as they come, otherwise swap when done
+    std::mutex mutex;
+    std::vector<ExplorerEntry> entries; //not yet picked up by UI
+    bool done = false;
+    bool error = false;
+};
+
+//ReadGenVersion results keyed by path, valid while mtime and size match
+//entries of other folders are dropped once MAX_ENTRIES is exceeded
+struct GenCache
+{
+    static const size_t MAX_ENTRIES = 4096;
+
+    struct Entry {
+        fs::file_time_type time;
+        uintmax_t size;
+        bool generated;
+    };
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+};
+
 std::string explorerPath;
 int explorerFilter = 0;
 ImGuiTableColumnSortSpecs explorerSorting;
 
 static int pathSel = -1;
 static std::vector<ExplorerEntry> data;
+static std::vector<ExplorerEntry> fresh; //non-progressive job results
+static std::shared_ptr<ListingJob> listing;
+static std::shared_ptr<GenCache> genCache = std::make_shared<GenCache>();
+static Worker explorerWorker;
 static std::vector<std::string> suggestions;
 static int suggestionSel = -1;
 static std::string lastPath;
 static bool scrollBack = false;
 static bool showSuggestions = false;
 static bool autocompleted = false;
+static bool refresh = false;
 enum MoveFocus { None, PathInput, FirstEntry };
 static MoveFocus moveFocus = None;
 
@@ -46,53 +85,100 @@ bool IsCppFile(const fs::path& p)
     return ext == ".c" || ext == ".cpp" || ext == ".cxx";
 }
 
-void ReloadExplorer(const CppGen& codeGen)
+void ListDirectory(std::shared_ptr<ListingJob> job, std::shared_ptr<GenCache> cache, fs::path path, int filter)
 {
-    data.clear();
-    auto path = u8path(explorerPath);
-    //+= '/' so it works with paths like "c:"
-    if (!path.has_root_directory())
-        path = u8path(explorerPath + (char)fs::path::preferred_separator);
-    path.make_preferred();
-    explorerPath = u8string(path);
-
-    if (!fs::is_directory(path)) {
-        messageBox.title = "Error";
-        messageBox.message = "Can't open \"" + explorerPath + "\"";
-        messageBox.buttons = ImRad::Ok;
-        messageBox.OpenPopup();
+    using clock = std::chrono::steady_clock;
+    const auto BATCH_TIME = std::chrono::milliseconds(50);
+    if (job->cancel)
+        return;
+    std::error_code ec;
+    if (!fs::is_directory(path, ec)) {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->error = true;
+        job->done = true;
         return;
     }
 
-    scrollBack = true;
+    CppGen codeGen; //ReadGenVersion doesn't depend on the instance
     std::ostringstream os;
     auto fsnow = fs::file_time_type::clock::now();
     auto snow = std::chrono::system_clock::now();
     os.imbue(std::locale(""));
-    std::error_code ec;
-    for (fs::directory_iterator it(path, ec); it != fs::directory_iterator(); ++it)
+    std::vector<ExplorerEntry> batch;
+    auto lastFlush = clock::now();
+    for (fs::directory_iterator it(path, ec); it != fs::directory_iterator(); it.increment(ec))
     {
+        if (job->cancel)
+            return;
         if (u8string(it->path().stem())[0] == '.')
             continue;
-        if (!it->is_directory() &&
-            (!explorerFilter && !IsHeaderFile(it->path())))
+        bool folder = it->is_directory(ec);
+        if (!folder && (!filter && !IsHeaderFile(it->path())))
             continue;
         ExplorerEntry entry;
         entry.path = u8string(it->path());
-        entry.folder = it->is_directory();
-        entry.generated = (IsHeaderFile(it->path()) || IsCppFile(it->path())) &&
-            codeGen.ReadGenVersion(entry.path);
+        entry.folder = folder;
+        entry.generated = false;
+        auto time = it->last_write_time(ec);
+        if (!folder && (IsHeaderFile(it->path()) || IsCppFile(it->path())))
+        {
+            uintmax_t size = it->file_size(ec);
+            std::unique_lock<std::mutex> lock(cache->mutex);
+            auto cit = cache->entries.find(entry.path);
+            if (cit != cache->entries.end() && cit->second.time == time && cit->second.size == size) {
+                entry.generated = cit->second.generated;
+            }
+            else {
+                lock.unlock();
+                entry.generated = codeGen.ReadGenVersion(entry.path);
+                lock.lock();
+                cache->entries[entry.path] = { time, size, entry.generated };
+            }
+        }
         entry.fileName = u8string(it->path().filename());
         auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-            it->last_write_time() - fsnow + snow);
+            time - fsnow + snow);
         entry.last_write_time = std::chrono::system_clock::to_time_t(sctp);
-        auto* tm = std::localtime(&entry.last_write_time);
+        std::tm tm; //std::localtime isn't thread safe
+#ifdef WIN32
+        localtime_s(&tm, &entry.last_write_time);
+#else
+        localtime_r(&entry.last_write_time, &tm);
+#endif
         os.str("");
-        os << std::put_time(tm, "%x %X");
+        os << std::put_time(&tm, "%x %X");
         entry.modified = os.str();
-        data.push_back(std::move(entry));
+        batch.push_back(std::move(entry));
+
+        if (clock::now() - lastFlush >= BATCH_TIME) {
+            lastFlush = clock::now();
+            std::lock_guard<std::mutex> lock(job->mutex);
+            std::move(batch.begin(), batch.end(), std::back_inserter(job->entries));
+            batch.clear();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        if (cache->entries.size() > GenCache::MAX_ENTRIES) {
+            std::string dir = u8string(path);
+            for (auto it = cache->entries.begin(); it != cache->entries.end(); ) {
+                if (u8string(u8path(it->first).parent_path()) != dir)
+                    it = cache->entries.erase(it);
+                else
+                    ++it;
+            }
+        }
     }
+    std::lock_guard<std::mutex> lock(job->mutex);
+    std::move(batch.begin(), batch.end(), std::back_inserter(job->entries));
+    job->done = true;
+}
+
+void SortExplorer()
+{
     stx::sort(data, [](const ExplorerEntry& a, const ExplorerEntry& b) {
+        if ((a.fileName == "..") != (b.fileName == ".."))
+            return a.fileName == "..";
         if (a.folder != b.folder)
             return a.folder;
         if (!explorerSorting.ColumnIndex) {
@@ -108,14 +194,85 @@ void ReloadExplorer(const CppGen& codeGen)
                 return a.last_write_time > b.last_write_time;
         }
         });
+}
+
+void ReloadExplorer(const CppGen& codeGen, bool resetScroll = true)
+{
+    auto path = u8path(explorerPath);
+    //+= '/' so it works with paths like "c:"
+    if (!path.has_root_directory())
+        path = u8path(explorerPath + (char)fs::path::preferred_separator);
+    path.make_preferred();
+    explorerPath = u8string(path);
+
+    if (listing)
+        listing->cancel = true;
+    listing = std::make_shared<ListingJob>();
+    //refresh keeps showing old content until new listing completes
+    listing->progressive = resetScroll;
+    fresh.clear();
+    if (resetScroll) {
+        scrollBack = true;
+        data.clear();
+    }
     if (!u8path(explorerPath).relative_path().empty()) {
-        std::string ppath = u8string(u8path(explorerPath).parent_path());
         ExplorerEntry e;
-        e.path = ppath;
+        e.path = u8string(u8path(explorerPath).parent_path());
         e.folder = true;
+        e.generated = false;
         e.fileName = "..";
-        data.insert(data.begin(), e);
+        e.last_write_time = 0;
+        (resetScroll ? data : fresh).push_back(e);
     }
+    explorerWorker.Post([job = listing, cache = genCache, path, filter = explorerFilter] {
+        ListDirectory(job, cache, path, filter);
+        });
+}
+
+void StopExplorer()
+{
+    if (listing)
+        listing->cancel = true;
+    explorerWorker.Stop();
+}
+
+//merges results of the running listing job
+void UpdateExplorer()
+{
+    if (!listing)
+        return;
+    bool done, error;
+    size_t n = 0;
+    {
+        std::lock_guard<std::mutex> lock(listing->mutex);
+        auto& dst = listing->progressive ? data : fresh;
+        n = listing->entries.size();
+        std::move(listing->entries.begin(), listing->entries.end(), std::back_inserter(dst));
+        listing->entries.clear();
+        done = listing->done;
+        error = listing->error;
+    }
+    if (done && !listing->progressive) {
+        data = std::move(fresh);
+        fresh.clear();
+        n = data.size();
+    }
+    if (n && (listing->progressive || done))
+        SortExplorer();
+    if (!done)
+        return;
+    listing.reset();
+    if (error) {
+        messageBox.title = "Error";
+        messageBox.message = "Can't open \"" + explorerPath + "\"";
+        messageBox.buttons = ImRad::Ok;
+        messageBox.OpenPopup();
+    }
+}
+
+void RefreshExplorer()
+{
+    refresh = true;
 }
 
 void GetSuggestions()
@@ -203,6 +360,11 @@ void ExplorerUI(const CppGen& codeGen, std::function<void(const std::string& fpa
         autocompleted = false;
         moveFocus = FirstEntry;
     }
+    else if (refresh) {
+        ReloadExplorer(codeGen, false);
+    }
+    refresh = false;
+    UpdateExplorer();
 
     //clickable path box
     const int sp = 4;
@@ -359,7 +521,7 @@ void ExplorerUI(const CppGen& codeGen, std::function<void(const std::string& fpa
     ImGui::SameLine(0, sp);
     ImGui::PushStyleColor(ImGuiCol_Text, 0xff404040);
     ImGui::PushItemFlag(ImGuiItemFlags_NoNav, true);
-    if (ImGui::Button(ICON_FA_ROTATE_RIGHT "##ego")) {
+    if (ImGui::Button(listing ? ICON_FA_HOURGLASS_HALF "##ego" : ICON_FA_ROTATE_RIGHT "##ego")) {
         ReloadExplorer(codeGen);
         moveFocus = FirstEntry;
     }
@@ -382,7 +544,7 @@ void ExplorerUI(const CppGen& codeGen, std::function<void(const std::string& fpa
         if (spec && spec->SpecsDirty) {
             spec->SpecsDirty = false;
             explorerSorting = *spec->Specs;
-            ReloadExplorer(codeGen);
+            SortExplorer();
         }
         ImGui::PushItemFlag(ImGuiItemFlags_NoNav, true);
         ImGui::TableHeadersRow();
@@ -394,7 +556,9 @@ void ExplorerUI(const CppGen& codeGen, std::function<void(const std::string& fpa
         int n = 0;
         for (const auto& entry : data)
         {
-            ImGui::PushID(n++);
+            //id by path so focused entry stays the same when listing is resorted
+            ++n;
+            ImGui::PushID(entry.path.c_str());
             bool source = IsHeaderFile(entry.path) || IsCppFile(entry.path);
             ImGui::PushStyleColor(ImGuiCol_Text,
                 entry.folder ? 0xff40b0b0 :
@@ -6,4 +6,8 @@ extern int explorerFilter;
 extern std::string explorerPath;
 extern ImGuiTableColumnSortSpecs explorerSorting;
 
+//rereads current folder on next ExplorerUI call
+void RefreshExplorer();
+//cancels listing in progress and joins the worker thread
+void StopExplorer();
 void ExplorerUI(const CppGen& codeGen, std::function<void (const std::string& fpath)> openFileFunc);
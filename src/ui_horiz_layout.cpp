@@ -259,6 +259,9 @@ void HorizLayout::Work()
     bool existingLayout = table && !table->header && !(table->flags & ImGuiTableFlags_Borders);
     float realPadding = padding * ctx->style.ItemSpacing.x;
     float realSpacing = spacing * ctx->style.ItemSpacing.x;
+    if (ctx->modified)
+        *ctx->modified = true;
+    UINode::MarkEdited(true); //reparents items
 
     if (alignment == 0) //left alignment
     {
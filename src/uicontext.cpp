@@ -1,6 +1,11 @@
 #include "uicontext.h"
 #include "cppgen.h"
 #include "node_standard.h"
+#include <imgui_internal.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
 
 UIContext& UIContext::Defaults()
 {
@@ -9,15 +14,36 @@ UIContext& UIContext::Defaults()
     return ctx;
 }
 
+//indentation is a prefix of a shared buffer of repeated INDENT so ind_up/ind_down
+//only move the end of the view and nothing gets copied
+//the buffer grows on demand, outgrown buffers are kept because views into them
+//can still be held by other contexts
+static std::string_view IndentBuffer(size_t n)
+{
+    static std::vector<std::unique_ptr<std::string>> bufs;
+    if (bufs.empty() || bufs.back()->size() < n)
+    {
+        size_t size = std::max(n, 64 * CppGen::INDENT.size());
+        if (!bufs.empty())
+            size = std::max(size, 2 * bufs.back()->size());
+        auto buf = std::make_unique<std::string>();
+        buf->reserve(size + CppGen::INDENT.size());
+        while (buf->size() < size)
+            buf->append(CppGen::INDENT);
+        bufs.push_back(std::move(buf));
+    }
+    return std::string_view(*bufs.back()).substr(0, n);
+}
+
 void UIContext::ind_up()
 {
-    ind += codeGen->INDENT;
+    ind = IndentBuffer(ind.size() + CppGen::INDENT.size());
 }
 
 void UIContext::ind_down()
 {
-    if (ind.size() >= codeGen->INDENT.size())
-        ind.resize(ind.size() - codeGen->INDENT.size());
+    size_t n = ind.size() >= CppGen::INDENT.size() ? ind.size() - CppGen::INDENT.size() : 0;
+    ind = IndentBuffer(n);
 }
 
 std::string UIContext::GetCurrentArray()
@@ -31,4 +57,249 @@ std::string UIContext::GetCurrentArray()
             return id;
     }
     return "";
-}
\ No newline at end of file
+}
+
+bool DrawCache::Update(ImU32 k)
+{
+    const ImGuiContext& g = *ImGui::GetCurrentContext();
+    if (k != key || g.InputEventsTrail.Size || g.InputEventsQueue.Size) {
+        key = k;
+        stableFrames = 0;
+        valid = false;
+    }
+    else
+        ++stableFrames;
+    replaying = valid;
+    return replaying;
+}
+
+void DrawCache::Invalidate()
+{
+    stableFrames = 0;
+    valid = replaying = false;
+}
+
+void DrawCache::BeginCapture(ImGuiWindow* win)
+{
+    idxMark = win->DrawList->IdxBuffer.Size;
+}
+
+void DrawCache::EndCapture(ImGuiWindow* win, bool cacheable)
+{
+    //let hover state and layout settle for a frame after the last change
+    if (!cacheable || stableFrames < 2 || valid)
+        return;
+    cmds.clear();
+    vtx.clear();
+    idx.clear();
+    valid = CaptureList(win->DrawList, idxMark);
+    rootCmds = cmds.size();
+    valid = valid && CaptureChildren(win);
+    cursorMaxPos = win->DC.CursorMaxPos - win->Pos;
+    idealMaxPos = win->DC.IdealMaxPos - win->Pos;
+}
+
+//child windows are rendered after their parent in submission order
+//see AddWindowToDrawData
+bool DrawCache::CaptureChildren(ImGuiWindow* win)
+{
+    for (ImGuiWindow* child : win->DC.ChildWindows)
+    {
+        if (!ImGui::IsWindowActiveAndVisible(child))
+            continue;
+        //auto-resizing child would be measured again when it reappears
+        if (child->HiddenFramesCannotSkipItems || child->HiddenFramesCanSkipItems ||
+            (child->ChildFlags & (ImGuiChildFlags_AutoResizeX | ImGuiChildFlags_AutoResizeY)))
+            return false;
+        if (!CaptureList(child->DrawList, 0) || !CaptureChildren(child))
+            return false;
+    }
+    return true;
+}
+
+bool DrawCache::CaptureList(const ImDrawList* dl, int idxStart)
+{
+    for (const ImDrawCmd& dc : dl->CmdBuffer)
+    {
+        if (dc.UserCallback)
+            return false;
+        int i0 = std::max((int)dc.IdxOffset, idxStart);
+        int i1 = dc.IdxOffset + dc.ElemCount;
+        if (i0 >= i1)
+            continue;
+        unsigned mi = UINT_MAX, ma = 0;
+        for (int i = i0; i < i1; ++i) {
+            mi = std::min(mi, (unsigned)dl->IdxBuffer[i]);
+            ma = std::max(ma, (unsigned)dl->IdxBuffer[i]);
+        }
+        Cmd cmd;
+        cmd.clipRect = dc.ClipRect;
+        cmd.texRef = dc.TexRef;
+        cmd.vtxOffset = (int)vtx.size();
+        cmd.vtxCount = ma - mi + 1;
+        cmd.idxOffset = (int)idx.size();
+        cmd.idxCount = i1 - i0;
+        if (sizeof(ImDrawIdx) == 2 && cmd.vtxCount >= (1 << 16))
+            return false;
+        const ImDrawVert* vbeg = dl->VtxBuffer.Data + dc.VtxOffset + mi;
+        vtx.insert(vtx.end(), vbeg, vbeg + cmd.vtxCount);
+        for (int i = i0; i < i1; ++i)
+            idx.push_back(ImDrawIdx(dl->IdxBuffer[i] - mi));
+        cmds.push_back(cmd);
+    }
+    return true;
+}
+
+//child windows are rendered after everything the parent submits in the frame
+//so their commands go to a separate channel which is merged in EndReplay
+void DrawCache::Replay(ImGuiWindow* win)
+{
+    ImDrawList* dl = win->DrawList;
+    splitter.Split(dl, 2);
+    splitter.SetCurrentChannel(dl, 1);
+    ReplayCmds(dl, rootCmds, cmds.size());
+    splitter.SetCurrentChannel(dl, 0);
+    ReplayCmds(dl, 0, rootCmds);
+    //keep window content size so autosize and scrollbars don't change
+    win->DC.CursorMaxPos = win->Pos + cursorMaxPos;
+    win->DC.IdealMaxPos = win->Pos + idealMaxPos;
+}
+
+void DrawCache::EndReplay(ImGuiWindow* win)
+{
+    splitter.Merge(win->DrawList);
+}
+
+void DrawCache::ReplayCmds(ImDrawList* dl, size_t from, size_t to)
+{
+    for (size_t c = from; c < to; ++c)
+    {
+        const Cmd& cmd = cmds[c];
+        dl->PushClipRect({ cmd.clipRect.x, cmd.clipRect.y }, { cmd.clipRect.z, cmd.clipRect.w });
+        dl->PushTexture(cmd.texRef);
+        dl->PrimReserve(cmd.idxCount, cmd.vtxCount);
+        unsigned base = dl->_VtxCurrentIdx;
+        memcpy(dl->_VtxWritePtr, vtx.data() + cmd.vtxOffset, cmd.vtxCount * sizeof(ImDrawVert));
+        for (int i = 0; i < cmd.idxCount; ++i)
+            dl->_IdxWritePtr[i] = ImDrawIdx(base + idx[cmd.idxOffset + i]);
+        dl->_VtxWritePtr += cmd.vtxCount;
+        dl->_IdxWritePtr += cmd.idxCount;
+        dl->_VtxCurrentIdx += cmd.vtxCount;
+        dl->PopTexture();
+        dl->PopClipRect();
+    }
+}
+
+//-------------------------------------------------------------------------
+
+void VarUsageIndex::Invalidate()
+{
+    valid = false;
+}
+
+void VarUsageIndex::Touch(UINode* node)
+{
+    if (valid && !stx::count(touched, node))
+        touched.push_back(node);
+}
+
+void VarUsageIndex::Sync(const std::vector<UINode*>& roots)
+{
+    //instance generation catches created and deleted nodes, tree generation nodes
+    //moved between trees and the clipboard. Otherwise only touched nodes are reindexed
+    if (valid && roots == indexedRoots &&
+        generation == UINode::instanceGeneration && treeGeneration == UINode::treeGeneration)
+    {
+        for (UINode* node : touched) {
+            const auto& tab = node->GetPropTable();
+            for (const auto* entries : { &tab.props, &tab.events })
+                for (const auto& e : *entries)
+                    Reindex(node->PropAt(e));
+        }
+        touched.clear();
+        return;
+    }
+
+    uses.clear();
+    propVars.clear();
+    touched.clear();
+    indexedRoots = roots;
+    generation = UINode::instanceGeneration;
+    treeGeneration = UINode::treeGeneration;
+    valid = true;
+    for (UINode* root : roots)
+        Add(root);
+}
+
+void VarUsageIndex::Add(UINode* node)
+{
+    const auto& tab = node->GetPropTable();
+    for (const auto* entries : { &tab.props, &tab.events })
+        for (const auto& e : *entries)
+            Reindex(node->PropAt(e));
+    for (auto& child : node->children)
+        Add(child.get());
+}
+
+void VarUsageIndex::Reindex(property_base* prop)
+{
+    auto vars = prop->used_variables();
+    stx::sort(vars);
+    vars.erase(stx::unique(vars), vars.end());
+
+    auto pit = propVars.find(prop);
+    if (pit != propVars.end())
+    {
+        if (pit->second == vars)
+            return;
+        for (const auto& var : pit->second) {
+            auto it = uses.find(var);
+            stx::erase(it->second, prop);
+            if (it->second.empty())
+                uses.erase(it);
+        }
+    }
+    for (const auto& var : vars) {
+        assert(var.find_first_of("[.") == std::string::npos);
+        uses[var].push_back(prop);
+    }
+    if (vars.empty()) {
+        if (pit != propVars.end())
+            propVars.erase(pit);
+    }
+    else if (pit != propVars.end())
+        pit->second = std::move(vars);
+    else
+        propVars.emplace(prop, std::move(vars));
+}
+
+bool VarUsageIndex::IsUsed(const std::vector<UINode*>& roots, const std::string& var)
+{
+    Sync(roots);
+    return uses.count(var);
+}
+
+std::vector<std::string> VarUsageIndex::UsedVars(const std::vector<UINode*>& roots)
+{
+    Sync(roots);
+    std::vector<std::string> vars;
+    vars.reserve(uses.size());
+    for (const auto& u : uses)
+        vars.push_back(u.first);
+    return vars;
+}
+
+void VarUsageIndex::Rename(const std::vector<UINode*>& roots, const std::string& oldn, const std::string& newn)
+{
+    Sync(roots);
+    auto it = uses.find(oldn);
+    if (it == uses.end())
+        return;
+    auto props = std::move(it->second);
+    uses.erase(it);
+    for (property_base* prop : props) {
+        stx::erase(propVars[prop], oldn); //already gone from uses
+        prop->rename_variable(oldn, newn);
+        Reindex(prop);
+    }
+}
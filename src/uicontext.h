@@ -1,7 +1,9 @@
 #pragma once
 #include <vector>
 #include <array>
+#include <map>
 #include <string>
+#include <string_view>
 #include <imgui.h>
 
 struct UINode;
@@ -10,6 +12,77 @@ class CppGen;
 struct property_base;
 struct ImGuiWindow;
 
+//Retained copy of what the design window rendered in the last full frame.
+//When nothing which affects rendering changed, TopWindow::Draw replays it
+//instead of evaluating the whole widget tree again
+class DrawCache
+{
+public:
+    //key covers state outside of the ImGui frame (model generation, selection, zoom, style)
+    //any input event forces a full redraw too
+    bool Update(ImU32 key);
+    void Invalidate();
+    bool Replaying() const { return replaying; }
+    //wraps window contents during a full redraw
+    void BeginCapture(ImGuiWindow* win);
+    void EndCapture(ImGuiWindow* win, bool cacheable);
+    //Replay/EndReplay wrap window contents instead when Replaying()
+    void Replay(ImGuiWindow* win);
+    void EndReplay(ImGuiWindow* win);
+
+private:
+    struct Cmd {
+        ImVec4 clipRect;
+        ImTextureRef texRef;
+        int vtxOffset, vtxCount;
+        int idxOffset, idxCount;
+    };
+    bool CaptureList(const ImDrawList* dl, int idxStart);
+    bool CaptureChildren(ImGuiWindow* win);
+    void ReplayCmds(ImDrawList* dl, size_t from, size_t to);
+
+    std::vector<Cmd> cmds;
+    size_t rootCmds = 0; //followed by child window commands
+    ImDrawListSplitter splitter;
+    std::vector<ImDrawVert> vtx;
+    std::vector<ImDrawIdx> idx; //relative to Cmd::vtxOffset
+    ImVec2 cursorMaxPos, idealMaxPos; //relative to window pos
+    ImU32 key = 0;
+    int stableFrames = 0;
+    int idxMark = 0;
+    bool valid = false;
+    bool replaying = false;
+};
+
+//Reverse index from field variable names to the properties using them.
+//Covers all configuration roots of a file so queries and renames are O(uses).
+//Structural changes are detected from UINode::instanceGeneration and treeGeneration
+//and trigger a full rebuild, edited nodes are reported with Touch and get
+//reindexed on the next query
+class VarUsageIndex
+{
+public:
+    void Touch(UINode* node);
+    void Invalidate();
+    bool IsUsed(const std::vector<UINode*>& roots, const std::string& var);
+    //sorted
+    auto UsedVars(const std::vector<UINode*>& roots) -> std::vector<std::string>;
+    void Rename(const std::vector<UINode*>& roots, const std::string& oldn, const std::string& newn);
+
+private:
+    void Sync(const std::vector<UINode*>& roots);
+    void Add(UINode* node);
+    void Reindex(property_base* prop);
+
+    std::map<std::string, std::vector<property_base*>> uses;
+    std::map<const property_base*, std::vector<std::string>> propVars;
+    std::vector<UINode*> touched;
+    std::vector<UINode*> indexedRoots;
+    unsigned generation = 0;
+    unsigned treeGeneration = 0;
+    bool valid = false;
+};
+
 struct UIContext
 {
     //set from outside
@@ -40,6 +113,7 @@ struct UIContext
     ImTextureID dashTexId = 0;
     bool* modified = nullptr;
     std::vector<UINode*> allRoots;
+    VarUsageIndex varUsage; //over allRoots
     bool showUntranslated = false;
 
     //snap result
@@ -62,14 +136,14 @@ struct UIContext
     ImGuiWindow* rootWin = nullptr;
     bool isAutoSize;
     ImU32 layoutHash = 0, prevLayoutHash = 0;
-    ImU32 prevDockspaceHash = 0;
     bool beingResized = false;
     std::vector<ImGuiWindow*> activePopups;
+    DrawCache drawCache;
     std::vector<UINode*> parents;
     std::vector<std::string> contextMenus;
     int kind = 0; //TopWindow::Kind
     ImVec2 selStart, selEnd;
-    std::string ind;
+    std::string_view ind; //view into a shared indentation buffer
     int varCounter;
     std::string parentVarName;
     std::string varItemIndex;
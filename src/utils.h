@@ -17,6 +17,12 @@ struct GLFWwindow;
 extern float uiFontSize;
 extern GLFWwindow* glfwWindow;
 
+//windowing and graphics services implemented by the application (imrad.cpp)
+//tools linking imrad_core without a window provide their own
+ImTextureID UploadTexture(const unsigned char* rgba, int w, int h);
+void DeleteTexture(ImTextureID id);
+bool OpenFileDialog(std::string& path, const std::vector<std::pair<const char*, const char*>>& filters);
+
 //-----------------------------------------------------------------------
 
 inline ImVec2 operator+ (const ImVec2& a, const ImVec2& b)
@@ -0,0 +1,46 @@
+#include "worker.h"
+
+Worker::~Worker()
+{
+    Stop();
+}
+
+void Worker::Post(std::function<void()> job)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (quit)
+        return;
+    jobs.push_back(std::move(job));
+    if (!thread.joinable())
+        thread = std::thread([this] { Run(); });
+    cond.notify_one();
+}
+
+void Worker::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+        jobs.clear();
+        cond.notify_one();
+    }
+    if (thread.joinable())
+        thread.join();
+}
+
+void Worker::Run()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [this] { return quit || !jobs.empty(); });
+            if (quit)
+                return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
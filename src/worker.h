@@ -0,0 +1,29 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+//Runs background jobs one after another on a single thread.
+//The thread is started by the first Post and joined by Stop, jobs which didn't
+//start yet are dropped then. Long jobs should check Stopping() or their own
+//cancel flag and return early
+class Worker
+{
+public:
+    ~Worker();
+    void Post(std::function<void()> job);
+    void Stop();
+    bool Stopping() const { return quit; }
+
+private:
+    void Run();
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<std::function<void()>> jobs;
+    std::thread thread;
+    std::atomic<bool> quit{ false };
+};